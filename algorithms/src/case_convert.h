@@ -0,0 +1,411 @@
+#ifndef CASE_CONVERT_H_
+#define CASE_CONVERT_H_
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	std::toupper looks at the current C locale on every call, so
+ *	uppercasing text with std::transform costs a function call and a table
+ *	lookup per byte. For ASCII letters the conversion is only "if the byte
+ *	lies between 'a' and 'z', clear bit 0x20", which SIMD instructions can
+ *	do for 32 or 64 bytes at once: one range compare gives a mask of the
+ *	letters and the case bit is flipped under that mask.
+ *
+ *	The ASCII kernels are chosen when the program is compiled:
+ *	- AVX-512 when built with -mavx512bw
+ *	- AVX2 when built with -mavx2
+ *	- otherwise 8 bytes at a time in a 64 bit register
+ *	Bytes of 0x80 and above are never changed by the ASCII functions.
+ *
+ *	The UTF-8 functions check that the text is valid UTF-8 as they go.
+ *	Runs of ASCII take the fast path; other characters are decoded one at a
+ *	time. Besides ASCII they convert the Latin-1 Supplement, Latin
+ *	Extended-A, Greek and Cyrillic letters, which all keep their encoded
+ *	length, so the text can be converted in place. Characters outside those
+ *	blocks, and the few whose other case is longer or shorter (such as
+ *	German sharp s, whose uppercase is "SS"), are left as they are.
+ */
+
+namespace case_detail
+{
+	/**
+	 * Flips the case bit of every byte in [first, last]. With Stop set it
+	 * returns at the first byte that is not ASCII, and the result is the
+	 * number of bytes before it; nothing from that byte on is changed. A
+	 * block holding such a byte is left to the byte by byte loop, which
+	 * stops exactly there.
+	 */
+	template <bool Stop>
+	std::size_t ascii_case(char* data, std::size_t size, char first, char last)
+	{
+		std::size_t i = 0;
+#if defined(__AVX512BW__)
+		const __m512i low = _mm512_set1_epi8(first);
+		const __m512i span = _mm512_set1_epi8(last - first);
+		const __m512i flip = _mm512_set1_epi8(0x20);
+		for (; i + 64 <= size; i += 64)
+		{
+			__m512i block = _mm512_loadu_si512(data + i);
+			if (Stop && _mm512_movepi8_mask(block))
+			{
+				break;
+			}
+			__mmask64 letters = _mm512_cmple_epu8_mask(
+					_mm512_sub_epi8(block, low), span);
+			_mm512_storeu_si512(data + i, _mm512_xor_si512(block,
+						_mm512_maskz_mov_epi8(letters, flip)));
+		}
+#elif defined(__AVX2__)
+		// Shifting the letters to the bottom of the signed byte range
+		// turns the range check into a single signed compare
+		const __m256i shift = _mm256_set1_epi8(static_cast<char>(0x80 - first));
+		const __m256i bound = _mm256_set1_epi8(
+				static_cast<char>(0x80 + (last - first) + 1));
+		const __m256i flip = _mm256_set1_epi8(0x20);
+		for (; i + 32 <= size; i += 32)
+		{
+			__m256i block = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(data + i));
+			if (Stop && _mm256_movemask_epi8(block))
+			{
+				break;
+			}
+			__m256i letters = _mm256_cmpgt_epi8(bound,
+					_mm256_add_epi8(block, shift));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i),
+					_mm256_xor_si256(block, _mm256_and_si256(letters, flip)));
+		}
+#else
+		// Eight bytes at a time: adding to the low seven bits of each byte
+		// sets its top bit when the byte is at least first, or above last
+		const std::uint64_t ones = 0x0101010101010101ULL;
+		const std::uint64_t high = 0x8080808080808080ULL;
+		for (; i + 8 <= size; i += 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, data + i, 8);
+			if (Stop && (word & high))
+			{
+				break;
+			}
+			std::uint64_t seven = word & ~high;
+			std::uint64_t at_least = seven + ones * (0x80 - first);
+			std::uint64_t above = seven + ones * (0x7f - last);
+			std::uint64_t letters = (at_least ^ above) & ~word & high;
+			word ^= letters >> 2;
+			std::memcpy(data + i, &word, 8);
+		}
+#endif
+		for (; i < size; i++)
+		{
+			if (Stop && static_cast<unsigned char>(data[i]) >= 0x80)
+			{
+				return i;
+			}
+			if (data[i] >= first && data[i] <= last)
+			{
+				data[i] ^= 0x20;
+			}
+		}
+		return size;
+	}
+
+	inline bool is_continuation(unsigned char byte)
+	{
+		return (byte & 0xC0) == 0x80;
+	}
+
+	/**
+	 * Length of the UTF-8 sequence at data, 0 if it is not valid, or -1 if
+	 * it is valid as far as it goes but the text ends before it does
+	 */
+	inline int sequence_length(const unsigned char* data, std::size_t size)
+	{
+		unsigned char lead = data[0];
+		int length;
+		unsigned char low = 0x80, high = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF)
+		{
+			length = 2;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			length = 3;
+			// No overlong forms, no UTF-16 surrogates
+			if (lead == 0xE0)
+			{
+				low = 0xA0;
+			}
+			else if (lead == 0xED)
+			{
+				high = 0x9F;
+			}
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			length = 4;
+			// No overlong forms, nothing above U+10FFFF
+			if (lead == 0xF0)
+			{
+				low = 0x90;
+			}
+			else if (lead == 0xF4)
+			{
+				high = 0x8F;
+			}
+		}
+		else
+		{
+			return 0;
+		}
+
+		for (int i = 1; i < length; i++)
+		{
+			if (static_cast<std::size_t>(i) == size)
+			{
+				return -1;
+			}
+			unsigned char byte = data[i];
+			if (i == 1 ? byte < low || byte > high : !is_continuation(byte))
+			{
+				return 0;
+			}
+		}
+		return length;
+	}
+
+	inline char32_t upper_of(char32_t c)
+	{
+		if ((c >= 0xE0 && c <= 0xFE && c != 0xF7)
+				|| (c >= 0x3B1 && c <= 0x3CB && c != 0x3C2)
+				|| (c >= 0x430 && c <= 0x44F))
+		{
+			return c - 0x20;
+		}
+		if ((c >= 0x100 && c <= 0x137 && (c & 1) && c != 0x131)
+				|| (c >= 0x139 && c <= 0x148 && !(c & 1))
+				|| (c >= 0x14A && c <= 0x177 && (c & 1))
+				|| (c >= 0x179 && c <= 0x17E && !(c & 1)))
+		{
+			return c - 1;
+		}
+		if (c >= 0x450 && c <= 0x45F)
+		{
+			return c - 0x50;
+		}
+		if (c >= 0x3AD && c <= 0x3AF)
+		{
+			return c - 0x25;
+		}
+		if (c == 0x3CD || c == 0x3CE)
+		{
+			return c - 0x3F;
+		}
+		switch (c)
+		{
+			case 0xB5: return 0x39C;
+			case 0xFF: return 0x178;
+			case 0x3AC: return 0x386;
+			case 0x3C2: return 0x3A3;
+			case 0x3CC: return 0x38C;
+		}
+		return c;
+	}
+
+	inline char32_t lower_of(char32_t c)
+	{
+		if ((c >= 0xC0 && c <= 0xDE && c != 0xD7)
+				|| (c >= 0x391 && c <= 0x3AB && c != 0x3A2)
+				|| (c >= 0x410 && c <= 0x42F))
+		{
+			return c + 0x20;
+		}
+		if ((c >= 0x100 && c <= 0x137 && !(c & 1) && c != 0x130)
+				|| (c >= 0x139 && c <= 0x148 && (c & 1))
+				|| (c >= 0x14A && c <= 0x177 && !(c & 1))
+				|| (c >= 0x179 && c <= 0x17E && (c & 1)))
+		{
+			return c + 1;
+		}
+		if (c >= 0x400 && c <= 0x40F)
+		{
+			return c + 0x50;
+		}
+		if (c >= 0x388 && c <= 0x38A)
+		{
+			return c + 0x25;
+		}
+		if (c == 0x38E || c == 0x38F)
+		{
+			return c + 0x3F;
+		}
+		switch (c)
+		{
+			case 0x178: return 0xFF;
+			case 0x386: return 0x3AC;
+			case 0x38C: return 0x3CC;
+		}
+		return c;
+	}
+
+	/**
+	 * Converts data in place and returns how many bytes were converted:
+	 * size when all of it is valid UTF-8, otherwise the offset of the first
+	 * bad sequence. truncated tells whether that sequence was only cut
+	 * short by the end of the text.
+	 */
+	template <bool Upper>
+	std::size_t utf8_case(char* data, std::size_t size, bool& truncated)
+	{
+		truncated = false;
+		std::size_t i = 0;
+		while (i < size)
+		{
+			i += Upper ? ascii_case<true>(data + i, size - i, 'a', 'z')
+				: ascii_case<true>(data + i, size - i, 'A', 'Z');
+			if (i == size)
+			{
+				break;
+			}
+
+			auto* bytes = reinterpret_cast<unsigned char*>(data + i);
+			int length = sequence_length(bytes, size - i);
+			if (length <= 0)
+			{
+				truncated = length < 0;
+				return i;
+			}
+
+			// Every letter converted here is a two byte sequence
+			if (length == 2)
+			{
+				char32_t c = (bytes[0] & 0x1F) << 6 | (bytes[1] & 0x3F);
+				c = Upper ? upper_of(c) : lower_of(c);
+				bytes[0] = 0xC0 | (c >> 6);
+				bytes[1] = 0x80 | (c & 0x3F);
+			}
+			i += length;
+		}
+		return i;
+	}
+}
+
+
+/**
+ * ASCII only: converts 'a' to 'z' and leaves every other byte alone
+ */
+inline void ascii_to_upper(char* data, std::size_t size)
+{
+	case_detail::ascii_case<false>(data, size, 'a', 'z');
+}
+
+inline void ascii_to_lower(char* data, std::size_t size)
+{
+	case_detail::ascii_case<false>(data, size, 'A', 'Z');
+}
+
+inline void ascii_to_upper(std::string& text)
+{
+	ascii_to_upper(text.data(), text.size());
+}
+
+inline void ascii_to_lower(std::string& text)
+{
+	ascii_to_lower(text.data(), text.size());
+}
+
+
+/**
+ * Converts UTF-8 text in place. Returns false, with the text converted up
+ * to the first invalid sequence, when the text is not valid UTF-8.
+ */
+inline bool to_upper(std::string& text)
+{
+	bool truncated;
+	return case_detail::utf8_case<true>(text.data(), text.size(), truncated)
+		== text.size();
+}
+
+inline bool to_lower(std::string& text)
+{
+	bool truncated;
+	return case_detail::utf8_case<false>(text.data(), text.size(), truncated)
+		== text.size();
+}
+
+
+/**
+ * Converts UTF-8 text that arrives in pieces, such as blocks read from a
+ * file. A character split between two pieces is held back until the rest
+ * of it arrives.
+ */
+class CaseConvertStream
+{
+	bool upper;
+	bool valid;
+	std::string pending;
+
+	public:
+	explicit CaseConvertStream(bool upper = true) : upper(upper), valid(true) {}
+
+	/**
+	 * Appends the converted piece to out. Returns false once invalid UTF-8
+	 * has been seen; out then ends just before the invalid sequence.
+	 */
+	bool convert(std::string_view piece, std::string& out)
+	{
+		if (!valid)
+		{
+			return false;
+		}
+
+		std::size_t start = out.size();
+		out.append(pending);
+		out.append(piece);
+		pending.clear();
+
+		std::size_t size = out.size() - start;
+		bool truncated;
+		std::size_t done = upper
+			? case_detail::utf8_case<true>(&out[start], size, truncated)
+			: case_detail::utf8_case<false>(&out[start], size, truncated);
+		if (done < size)
+		{
+			if (truncated)
+			{
+				pending.assign(out, start + done, std::string::npos);
+			}
+			else
+			{
+				valid = false;
+			}
+			out.resize(start + done);
+		}
+		return valid;
+	}
+
+	/**
+	 * Call after the last piece: false if the text was invalid or ended in
+	 * the middle of a character
+	 */
+	bool finish()
+	{
+		if (!pending.empty())
+		{
+			valid = false;
+			pending.clear();
+		}
+		return valid;
+	}
+};
+
+#endif
@@ -1,28 +1,29 @@
-#include <iostream>
 #include <vector>
 #include <algorithm>
-#include <iterator>
+
+#include "fast_output.h"
+#include "filter.h"
 
 int main()
 {
 	std::vector<int> sequence {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
-	auto output = std::ostream_iterator<int> (std::cout, " ");
+	OutputBuffer buffer;
+	auto output = OutputBufferIterator<int> (buffer, " ");
 
 	// Display sequence
 	std::copy(std::begin(sequence), std::end(sequence), output);
-	std::cout << "\n";
+	buffer << "\n";
 
 	// A function to test for evenness
 	auto is_even = [] (int x) { return x % 2 == 0; };
-	int even_count = std::count_if(std::begin(sequence), std::end(sequence), 
-			is_even);
 
-	// Populate second sequence with even values
-	std::vector<int> sequenceTwo(even_count);
-	std::copy_if(std::begin(sequence), std::end(sequence), 
-			std::begin(sequenceTwo), is_even);
+	// Populate second sequence with even values in a single pass
+	auto sequenceTwo = filter(sequence, is_even);
 	
 	// Display sequence with even numbers
 	std::copy(std::begin(sequenceTwo), std::end(sequenceTwo), output);
-	std::cout << "\n";
+	buffer << "\n";
+
+	// Writes that failed, to a full disk for example, show in the exit status
+	return buffer.flush() ? 0 : 1;
 }
@@ -1,6 +1,9 @@
 #include <iostream>
 #include <vector>
 #include <iterator>
+#include <string>
+
+#include "fast_output.h"
 
 int main()
 {
@@ -11,4 +14,26 @@ int main()
 	auto stream = std::ostream_iterator<int> (std::cout, " ");
 	std::copy(std::begin(sequence), std::end(sequence), stream);
 	std::cout << "\n";
+
+	// The same through an OutputBuffer, which formats with std::to_chars and
+	// writes to standard output in large blocks
+	std::cout << std::flush;
+	OutputBuffer output;
+	std::copy(std::begin(sequence), std::end(sequence),
+			OutputBufferIterator<int>(output, " "));
+	output << "\n";
+
+	// Floating point numbers and strings work the same way
+	std::vector<double> halves {0.5, 1.5, 2.25, 1e-7};
+	std::copy(std::begin(halves), std::end(halves),
+			OutputBufferIterator<double>(output, " "));
+	output << "\n";
+
+	std::vector<std::string> words {"copy", "to", "stream"};
+	std::copy(std::begin(words), std::end(words),
+			OutputBufferIterator<std::string>(output, " "));
+	output << "\n";
+
+	// Writes that failed, to a full disk for example, show in the exit status
+	return output.flush() ? 0 : 1;
 }
@@ -0,0 +1,341 @@
+#ifndef FAST_FIND_H_
+#define FAST_FIND_H_
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	find_value is std::find for contiguous ranges of numbers. Instead of
+ *	comparing one element per step it compares a whole SIMD register of
+ *	them (32 bytes with AVX2, 64 with AVX-512) and turns the result into a
+ *	bit mask, whose lowest set bit is the position of the first match.
+ *	Without AVX2 it falls back to std::find.
+ *
+ *	A linear search, however fast, reads the whole array for every miss.
+ *	For many lookups against the same data EytzingerIndex keeps a sorted
+ *	copy laid out in breadth first order, as in a binary heap: the root is
+ *	at position 1 and the children of position k are at 2k and 2k + 1.
+ *	A search moves down with k = 2k + (b[k] < x), which has no branch to
+ *	mispredict, and the 64 / sizeof(Type) descendants of k a few levels
+ *	down (four levels for 4 byte elements) sit next to each other at k *
+ *	64 / sizeof(Type). The tree is stored on a 64 byte boundary, so for
+ *	element sizes that divide 64 those descendants fill exactly one cache
+ *	line and come in with a single prefetch while the levels in between
+ *	are compared.
+ *
+ *	The batched searches walk several queries down the tree in step. Each
+ *	query waits on memory at every level, but the waits of the queries in
+ *	a group overlap instead of following one another.
+ */
+
+namespace find_detail
+{
+	/**
+	 * Allocates on 64 byte boundaries, so that element k * (64 / size)
+	 * starts a cache line
+	 */
+	template <typename Type>
+	struct CacheLineAllocator
+	{
+		using value_type = Type;
+
+		static constexpr std::align_val_t ALIGNMENT {64};
+
+		CacheLineAllocator() = default;
+
+		template <typename Other>
+		CacheLineAllocator(const CacheLineAllocator<Other>&) {}
+
+		Type* allocate(std::size_t size)
+		{
+			return static_cast<Type*>(::operator new(size * sizeof(Type), ALIGNMENT));
+		}
+
+		void deallocate(Type* data, std::size_t)
+		{
+			::operator delete(data, ALIGNMENT);
+		}
+
+		template <typename Other>
+		bool operator==(const CacheLineAllocator<Other>&) const
+		{
+			return true;
+		}
+
+		template <typename Other>
+		bool operator!=(const CacheLineAllocator<Other>&) const
+		{
+			return false;
+		}
+	};
+
+#if defined(__AVX512F__)
+	template <typename Type>
+	const Type* find_simd(const Type* first, const Type* last, Type value)
+	{
+		constexpr std::size_t LANES = 64 / sizeof(Type);
+		for (; last - first >= static_cast<std::ptrdiff_t>(LANES); first += LANES)
+		{
+			std::uint64_t mask;
+			if constexpr (std::is_same<Type, float>::value)
+			{
+				mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(first),
+						_mm512_set1_ps(value), _CMP_EQ_OQ);
+			}
+			else if constexpr (std::is_same<Type, double>::value)
+			{
+				mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(first),
+						_mm512_set1_pd(value), _CMP_EQ_OQ);
+			}
+			else if constexpr (sizeof(Type) == 4)
+			{
+				mask = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(first),
+						_mm512_set1_epi32(value));
+			}
+			else
+			{
+				mask = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(first),
+						_mm512_set1_epi64(value));
+			}
+			if (mask)
+			{
+				return first + __builtin_ctzll(mask);
+			}
+		}
+		return std::find(first, last, value);
+	}
+#elif defined(__AVX2__)
+	template <typename Type>
+	const Type* find_simd(const Type* first, const Type* last, Type value)
+	{
+		constexpr std::size_t LANES = 32 / sizeof(Type);
+		for (; last - first >= static_cast<std::ptrdiff_t>(LANES); first += LANES)
+		{
+			// One bit per byte, so each element owns sizeof(Type) bits
+			unsigned mask;
+			if constexpr (std::is_same<Type, float>::value)
+			{
+				mask = _mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(
+								_mm256_loadu_ps(first), _mm256_set1_ps(value),
+								_CMP_EQ_OQ)));
+			}
+			else if constexpr (std::is_same<Type, double>::value)
+			{
+				mask = _mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(
+								_mm256_loadu_pd(first), _mm256_set1_pd(value),
+								_CMP_EQ_OQ)));
+			}
+			else if constexpr (sizeof(Type) == 4)
+			{
+				mask = _mm256_movemask_epi8(_mm256_cmpeq_epi32(
+							_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)),
+							_mm256_set1_epi32(value)));
+			}
+			else
+			{
+				mask = _mm256_movemask_epi8(_mm256_cmpeq_epi64(
+							_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)),
+							_mm256_set1_epi64x(value)));
+			}
+			if (mask)
+			{
+				return first + __builtin_ctz(mask) / sizeof(Type);
+			}
+		}
+		return std::find(first, last, value);
+	}
+#endif
+}
+
+
+/**
+ * First element of [first, last) equal to value, or last
+ */
+template <typename Type>
+const Type* find_value(const Type* first, const Type* last, Type value)
+{
+#if defined(__AVX2__) || defined(__AVX512F__)
+	if constexpr (std::is_arithmetic<Type>::value && !std::is_same<Type, bool>::value
+			&& (sizeof(Type) == 4 || sizeof(Type) == 8))
+	{
+		return find_detail::find_simd(first, last, value);
+	}
+#endif
+	return std::find(first, last, value);
+}
+
+
+template <typename Type, typename Allocator>
+typename std::vector<Type, Allocator>::const_iterator find_value(
+		const std::vector<Type, Allocator>& values, Type value)
+{
+	const Type* found = find_value(values.data(),
+			values.data() + values.size(), value);
+	return std::begin(values) + (found - values.data());
+}
+
+
+/**
+ * Build once, search many times: a sorted copy of the values in Eytzinger
+ * (breadth first) order
+ */
+template <typename Type, typename Compare = std::less<Type>>
+class EytzingerIndex
+{
+	// Position 0 is unused, so the children of k are 2k and 2k + 1
+	std::vector<Type, find_detail::CacheLineAllocator<Type>> tree;
+	std::size_t count;
+	Compare compare;
+
+	// Elements per 64 byte cache line, and so the number of descendants
+	// log2(PER_LINE) levels down that share one line
+	static constexpr std::size_t PER_LINE = 64 / sizeof(Type) > 0
+		? 64 / sizeof(Type) : 1;
+
+	std::size_t fill(const std::vector<Type>& sorted, std::size_t next,
+			std::size_t k)
+	{
+		if (k <= count)
+		{
+			next = fill(sorted, next, 2 * k);
+			tree[k] = sorted[next++];
+			next = fill(sorted, next, 2 * k + 1);
+		}
+		return next;
+	}
+
+	void prefetch(std::size_t k) const
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		if (k * PER_LINE <= count)
+		{
+			__builtin_prefetch(&tree[k * PER_LINE]);
+		}
+#endif
+	}
+
+	/**
+	 * The path to a lower bound ends with a step right, past every node
+	 * that compared less, followed by steps left. Undoing the trailing
+	 * left steps and the last right step gives the node itself.
+	 */
+	static std::size_t settle(std::size_t k)
+	{
+		return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+	}
+
+	public:
+	template <typename Iterator>
+	EytzingerIndex(Iterator first, Iterator last, Compare compare = Compare()) :
+		count(0), compare(compare)
+	{
+		std::vector<Type> sorted(first, last);
+		std::sort(std::begin(sorted), std::end(sorted), this->compare);
+		count = sorted.size();
+		tree.resize(count + 1);
+		fill(sorted, 0, 1);
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	/**
+	 * The smallest value that is not less than value, or nullptr when
+	 * every value is less
+	 */
+	const Type* lower_bound(const Type& value) const
+	{
+		std::size_t k = 1;
+		while (k <= count)
+		{
+			prefetch(k);
+			k = 2 * k + compare(tree[k], value);
+		}
+		k = settle(k);
+		return k ? &tree[k] : nullptr;
+	}
+
+	bool contains(const Type& value) const
+	{
+		const Type* bound = lower_bound(value);
+		return bound && !compare(value, *bound);
+	}
+
+	/**
+	 * lower_bound for each of values[0 .. size), Group searches at a time
+	 */
+	template <std::size_t Group = 16>
+	void lower_bound(const Type* values, std::size_t size,
+			const Type** results) const
+	{
+		std::size_t done = 0;
+		for (; done + Group <= size; done += Group)
+		{
+			std::size_t k[Group];
+			for (std::size_t g = 0; g < Group; g++)
+			{
+				k[g] = 1;
+			}
+
+			// Every path has the same length give or take one level, so
+			// the searches finish together
+			bool active = true;
+			while (active)
+			{
+				active = false;
+				for (std::size_t g = 0; g < Group; g++)
+				{
+					if (k[g] <= count)
+					{
+						prefetch(k[g]);
+						k[g] = 2 * k[g] + compare(tree[k[g]], values[done + g]);
+						active = true;
+					}
+				}
+			}
+
+			for (std::size_t g = 0; g < Group; g++)
+			{
+				std::size_t found = settle(k[g]);
+				results[done + g] = found ? &tree[found] : nullptr;
+			}
+		}
+		for (; done < size; done++)
+		{
+			results[done] = lower_bound(values[done]);
+		}
+	}
+
+	/**
+	 * contains for each of values[0 .. size)
+	 */
+	void contains(const Type* values, std::size_t size, bool* results) const
+	{
+		constexpr std::size_t CHUNK = 256;
+		const Type* bounds[CHUNK];
+		for (std::size_t start = 0; start < size; start += CHUNK)
+		{
+			std::size_t length = std::min(CHUNK, size - start);
+			lower_bound(values + start, length, bounds);
+			for (std::size_t i = 0; i < length; i++)
+			{
+				results[start + i] = bounds[i]
+					&& !compare(values[start + i], *bounds[i]);
+			}
+		}
+	}
+};
+
+#endif
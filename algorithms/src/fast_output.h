@@ -0,0 +1,245 @@
+#ifndef FAST_OUTPUT_H_
+#define FAST_OUTPUT_H_
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <iterator>
+#include <type_traits>
+#include <cstring>
+#include <cerrno>
+#include <cstddef>
+
+#include <unistd.h>
+#include <sys/uio.h>
+
+/**
+ * NOTE:
+ *	std::ostream_iterator sends every element through operator<<, which
+ *	consults the stream's locale, checks its state and, for std::cout, keeps
+ *	it in step with C stdio. For millions of elements that overhead is most
+ *	of the running time.
+ *
+ *	OutputBuffer formats numbers with std::to_chars, which uses no locale,
+ *	into one large buffer and hands the buffer to the operating system with
+ *	write() only when it is full. Strings that do not fit are sent together
+ *	with the buffered bytes in a single writev() call instead of being
+ *	copied.
+ *
+ *	The buffer writes straight to a file descriptor, past any buffering of
+ *	std::cout. When both are used on the same descriptor, flush whichever
+ *	was written last before switching to the other.
+ *
+ *	Errors are reported like a stream's failbit: when write() fails for
+ *	any reason but an interrupted call (a closed pipe, a full disk, a bad
+ *	descriptor), failed() becomes true and stays true, error() holds the
+ *	errno value, and later output is dropped. flush() returns false once
+ *	output has been lost, so check it, or failed(), after the last write.
+ */
+class OutputBuffer
+{
+	int descriptor;
+	char* buffer;
+	std::size_t capacity;
+	std::size_t used;
+	int write_error;
+
+	// Longest text std::to_chars produces for any arithmetic type
+	static constexpr std::size_t NUMBER_ROOM = 64;
+
+	void write_all(struct iovec* parts, int count)
+	{
+		while (count > 0 && write_error == 0)
+		{
+			ssize_t written = ::writev(descriptor, parts, count);
+			if (written < 0)
+			{
+				if (errno != EINTR)
+				{
+					write_error = errno;
+				}
+				continue;
+			}
+
+			// Skip what was written; a partial write leaves the rest
+			while (count > 0 && static_cast<std::size_t>(written) >= parts->iov_len)
+			{
+				written -= parts->iov_len;
+				parts++;
+				count--;
+			}
+			if (count > 0)
+			{
+				parts->iov_base = static_cast<char*>(parts->iov_base) + written;
+				parts->iov_len -= written;
+			}
+		}
+	}
+
+	template <typename Number>
+	void put_number(Number value)
+	{
+		if (capacity - used < NUMBER_ROOM)
+		{
+			flush();
+		}
+		auto result = std::to_chars(buffer + used, buffer + capacity, value);
+		used = result.ptr - buffer;
+	}
+
+	public:
+	explicit OutputBuffer(int descriptor = STDOUT_FILENO,
+			std::size_t capacity = 1 << 16) :
+		descriptor(descriptor), buffer(nullptr),
+		capacity(capacity > NUMBER_ROOM ? capacity : NUMBER_ROOM), used(0),
+		write_error(0)
+	{
+		buffer = new char[this->capacity];
+	}
+
+	OutputBuffer(const OutputBuffer&) = delete;
+	OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+	~OutputBuffer()
+	{
+		flush();
+		delete[] buffer;
+	}
+
+	/**
+	 * Writes out the buffered bytes; false if any output has been lost
+	 */
+	bool flush()
+	{
+		if (used > 0)
+		{
+			struct iovec part = {buffer, used};
+			write_all(&part, 1);
+			used = 0;
+		}
+		return write_error == 0;
+	}
+
+	bool failed() const
+	{
+		return write_error != 0;
+	}
+
+	/**
+	 * The errno value of the write that failed, 0 if none has
+	 */
+	int error() const
+	{
+		return write_error;
+	}
+
+	void put(char value)
+	{
+		if (used == capacity)
+		{
+			flush();
+		}
+		buffer[used++] = value;
+	}
+
+	void put(std::string_view text)
+	{
+		if (text.size() <= capacity - used)
+		{
+			std::memcpy(buffer + used, text.data(), text.size());
+			used += text.size();
+			return;
+		}
+
+		// Too long to buffer: send the buffer and the text together
+		struct iovec parts[2] = {
+			{buffer, used},
+			{const_cast<char*>(text.data()), text.size()}
+		};
+		write_all(parts, 2);
+		used = 0;
+	}
+
+	void put(const char* text)
+	{
+		put(std::string_view(text));
+	}
+
+	void put(const std::string& text)
+	{
+		put(std::string_view(text));
+	}
+
+	void put(bool value)
+	{
+		put(value ? '1' : '0');
+	}
+
+	/**
+	 * Integers and floating point numbers. Floating point numbers come out
+	 * in the shortest form that reads back to the same value.
+	 */
+	template <typename Number,
+			 typename = std::enable_if_t<std::is_arithmetic<Number>::value>>
+	void put(Number value)
+	{
+		put_number(value);
+	}
+
+	template <typename Type>
+	OutputBuffer& operator<<(const Type& value)
+	{
+		put(value);
+		return *this;
+	}
+};
+
+
+/**
+ * Output iterator over an OutputBuffer that writes each assigned value
+ * followed by delimiter, like std::ostream_iterator. It is a drop-in
+ * target for std::copy, std::transform and the other algorithms.
+ */
+template <typename Type>
+class OutputBufferIterator
+{
+	OutputBuffer* output;
+	std::string_view delimiter;
+
+	public:
+	using iterator_category = std::output_iterator_tag;
+	using value_type = void;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = void;
+
+	OutputBufferIterator(OutputBuffer& output, const char* delimiter = "") :
+		output(&output), delimiter(delimiter) {}
+
+	OutputBufferIterator& operator=(const Type& value)
+	{
+		output->put(value);
+		if (!delimiter.empty())
+		{
+			output->put(delimiter);
+		}
+		return *this;
+	}
+
+	OutputBufferIterator& operator*()
+	{
+		return *this;
+	}
+
+	OutputBufferIterator& operator++()
+	{
+		return *this;
+	}
+
+	OutputBufferIterator& operator++(int)
+	{
+		return *this;
+	}
+};
+
+#endif
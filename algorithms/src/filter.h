@@ -0,0 +1,318 @@
+#ifndef FILTER_H_
+#define FILTER_H_
+
+#include <vector>
+#include <array>
+#include <thread>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	Keeping the elements of a sequence that satisfy a predicate with
+ *	std::count_if followed by std::copy_if reads the input twice, and
+ *	sizing the output with std::vector<Type>(count) also writes zeros over
+ *	the whole output before copy_if overwrites them.
+ *
+ *	filter reads the input once. The output must have room for every
+ *	input element; the number kept is only known at the end.
+ *
+ *	For 4 and 8 byte elements (int, float, double, pointers, ...) the
+ *	kernel tests a block of elements, turns the results into a bit mask,
+ *	and writes the kept elements of the block with one SIMD store:
+ *	- AVX-512 compress stores when built with -mavx512f
+ *	- AVX2 shuffles from a table of the 256 (or 16) possible masks when
+ *	  built with -mavx2
+ *	- otherwise every element is stored and the output position only moves
+ *	  on when it is kept, which needs no branches
+ *	The SIMD stores write a whole block even when fewer elements are kept;
+ *	the extra slots are overwritten by later blocks, and the kernel never
+ *	writes past the output limit it is given.
+ *
+ *	parallel_filter splits the input into chunks. The threads count the
+ *	matches of each chunk, a prefix sum of the counts gives each chunk's
+ *	place in the output, and the threads then filter their chunks straight
+ *	into place.
+ */
+
+namespace filter_detail
+{
+	/**
+	 * Table of AVX2 lane permutations: entry mask moves the 32 bit lanes of
+	 * the elements selected by mask to the front. Elements of Size bytes
+	 * take Size / 4 lanes each, so 8 byte elements use 16 entries of pairs.
+	 */
+	template <std::size_t Size>
+	struct CompactTable
+	{
+		static constexpr std::size_t ELEMENTS = 32 / Size;
+		static constexpr std::size_t LANES = Size / 4;
+
+		alignas(32) std::int32_t entries[1 << ELEMENTS][8];
+
+		constexpr CompactTable() : entries()
+		{
+			for (std::size_t mask = 0; mask < (1u << ELEMENTS); mask++)
+			{
+				std::size_t next = 0;
+				for (std::size_t element = 0; element < ELEMENTS; element++)
+				{
+					if (mask & (1u << element))
+					{
+						for (std::size_t lane = 0; lane < LANES; lane++)
+						{
+							entries[mask][next++] = element * LANES + lane;
+						}
+					}
+				}
+				while (next < 8)
+				{
+					entries[mask][next++] = 0;
+				}
+			}
+		}
+	};
+
+	template <std::size_t Size>
+	inline constexpr CompactTable<Size> COMPACT_TABLE {};
+
+	template <typename Type>
+	constexpr bool is_compactable = std::is_trivially_copyable<Type>::value
+		&& (sizeof(Type) == 4 || sizeof(Type) == 8);
+
+	/**
+	 * Tests Block elements and returns one bit per kept element
+	 */
+	template <std::size_t Block, typename Type, typename Predicate>
+	unsigned block_mask(const Type* data, Predicate& predicate)
+	{
+		unsigned mask = 0;
+		for (std::size_t i = 0; i < Block; i++)
+		{
+			mask |= static_cast<unsigned>(static_cast<bool>(predicate(data[i]))) << i;
+		}
+		return mask;
+	}
+}
+
+
+/**
+ * Writes the elements of [first, last) that satisfy predicate to out, in
+ * order, and returns the end of what was written. Nothing is written at or
+ * after out_limit; when out_limit - out is at least last - first every
+ * kept element fits.
+ *
+ * out may equal first, which filters a sequence in place.
+ */
+template <typename Type, typename Predicate>
+Type* filter(const Type* first, const Type* last, Type* out, Type* out_limit,
+		Predicate predicate)
+{
+	using namespace filter_detail;
+
+	if constexpr (is_compactable<Type>)
+	{
+#if defined(__AVX512F__)
+		constexpr std::size_t BLOCK = 64 / sizeof(Type);
+		while (last - first >= static_cast<std::ptrdiff_t>(BLOCK)
+				&& out_limit - out >= static_cast<std::ptrdiff_t>(BLOCK))
+		{
+			unsigned mask = block_mask<BLOCK>(first, predicate);
+			__m512i block = _mm512_loadu_si512(first);
+			if constexpr (sizeof(Type) == 4)
+			{
+				_mm512_mask_compressstoreu_epi32(out, mask, block);
+			}
+			else
+			{
+				_mm512_mask_compressstoreu_epi64(out, mask, block);
+			}
+			out += __builtin_popcount(mask);
+			first += BLOCK;
+		}
+#elif defined(__AVX2__)
+		constexpr std::size_t BLOCK = 32 / sizeof(Type);
+		const auto& table = COMPACT_TABLE<sizeof(Type)>;
+		while (last - first >= static_cast<std::ptrdiff_t>(BLOCK)
+				&& out_limit - out >= static_cast<std::ptrdiff_t>(BLOCK))
+		{
+			unsigned mask = block_mask<BLOCK>(first, predicate);
+			__m256i block = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(first));
+			__m256i order = _mm256_load_si256(
+					reinterpret_cast<const __m256i*>(table.entries[mask]));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+					_mm256_permutevar8x32_epi32(block, order));
+			out += __builtin_popcount(mask);
+			first += BLOCK;
+		}
+#endif
+
+		// Store every element, keep the ones that match
+		for (; first != last && out != out_limit; ++first)
+		{
+			Type value = *first;
+			*out = value;
+			out += static_cast<bool>(predicate(value));
+		}
+		return out;
+	}
+	else
+	{
+		for (; first != last && out != out_limit; ++first)
+		{
+			if (predicate(*first))
+			{
+				*out++ = *first;
+			}
+		}
+		return out;
+	}
+}
+
+
+template <typename Type, typename Predicate>
+Type* filter(const Type* first, const Type* last, Type* out,
+		Predicate predicate)
+{
+	return filter(first, last, out, out + (last - first), predicate);
+}
+
+
+/**
+ * An allocator that leaves elements uninitialised when a vector grows with
+ * resize(), instead of setting them to zero. Vectors of plain numbers
+ * about to be overwritten can then be sized for free.
+ */
+template <typename Type>
+class DefaultInitAllocator : public std::allocator<Type>
+{
+	using Base = std::allocator<Type>;
+
+	public:
+	template <typename Other>
+	struct rebind
+	{
+		using other = DefaultInitAllocator<Other>;
+	};
+
+	DefaultInitAllocator() = default;
+
+	template <typename Other>
+	DefaultInitAllocator(const DefaultInitAllocator<Other>&) {}
+
+	template <typename Other>
+	void construct(Other* place)
+	{
+		::new (static_cast<void*>(place)) Other;
+	}
+
+	template <typename Other, typename... Args>
+	void construct(Other* place, Args&&... args)
+	{
+		::new (static_cast<void*>(place)) Other(std::forward<Args>(args)...);
+	}
+};
+
+template <typename Type>
+using FilteredVector = std::vector<Type, DefaultInitAllocator<Type>>;
+
+
+/**
+ * The elements of input that satisfy predicate. The result keeps the
+ * capacity of the input; call shrink_to_fit when few elements are kept and
+ * the result is kept for long.
+ */
+template <typename Type, typename Allocator, typename Predicate>
+FilteredVector<Type> filter(const std::vector<Type, Allocator>& input,
+		Predicate predicate)
+{
+	FilteredVector<Type> output;
+	output.resize(input.size());
+	Type* end = filter(input.data(), input.data() + input.size(),
+			output.data(), predicate);
+	output.resize(end - output.data());
+	return output;
+}
+
+
+/**
+ * filter using several threads. The result is the same as filter's: the
+ * kept elements in their original order.
+ */
+template <typename Type, typename Predicate>
+Type* parallel_filter(const Type* first, const Type* last, Type* out,
+		Predicate predicate, unsigned threads = std::thread::hardware_concurrency())
+{
+	std::size_t size = last - first;
+
+	// Below a few pages per thread, starting threads costs more than it saves
+	constexpr std::size_t MIN_CHUNK = 1 << 14;
+	if (threads > size / MIN_CHUNK)
+	{
+		threads = static_cast<unsigned>(size / MIN_CHUNK);
+	}
+	if (threads <= 1)
+	{
+		return filter(first, last, out, predicate);
+	}
+
+	std::vector<std::size_t> offsets(threads + 1, 0);
+	auto chunk = [&] (unsigned t)
+	{
+		return std::make_pair(first + size * t / threads,
+				first + size * (t + 1) / threads);
+	};
+
+	// Run work(t) for every chunk, one on this thread
+	auto run = [&] (auto work)
+	{
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < threads; t++)
+		{
+			workers.emplace_back(work, t);
+		}
+		work(0);
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	};
+
+	run([&] (unsigned t)
+		{
+			auto [from, to] = chunk(t);
+			std::size_t count = 0;
+			for (; from != to; ++from)
+			{
+				count += static_cast<bool>(predicate(*from));
+			}
+			offsets[t + 1] = count;
+		});
+
+	for (unsigned t = 0; t < threads; t++)
+	{
+		offsets[t + 1] += offsets[t];
+	}
+
+	// Each chunk's output ends where the next one starts, so the limit
+	// keeps the SIMD stores from spilling into a neighbour
+	run([&] (unsigned t)
+		{
+			auto [from, to] = chunk(t);
+			filter(from, to, out + offsets[t], out + offsets[t + 1], predicate);
+		});
+
+	return out + offsets[threads];
+}
+
+#endif
@@ -0,0 +1,376 @@
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	Chaining std::iota, std::copy and std::transform through temporary
+ *	vectors allocates each temporary and passes over memory once per step.
+ *	A Pipeline instead records its steps and does nothing until a final
+ *	operation (for_each, to_vector, reduce, sum, count) asks for a result;
+ *	then every element travels through all the steps before the next one
+ *	is produced, in a single loop, and nothing in between is stored.
+ *
+ *		auto doubled = stream_iota(0, 20)
+ *			.map([] (int x) { return 2 * x; })
+ *			.filter([] (int x) { return x % 3 == 0; })
+ *			.to_vector();
+ *
+ *	Each step wraps the step after it: map(f) turns "give x to next" into
+ *	"give f(x) to next", filter(p) into "give x to next when p(x)". The
+ *	wrapped functions are known at compile time, so the compiler can
+ *	inline the whole chain into the loop over the source.
+ *
+ *	Execution is serial unless parallel(threads, chunk) is asked for. The
+ *	source is then cut into chunks of chunk elements that the threads take
+ *	in turn. to_vector and reduce keep each chunk's result apart and join
+ *	them in order, so the result is the same as the serial one (reduce
+ *	needs an associative operation); for_each calls its function from
+ *	several threads at once and in no particular order.
+ */
+
+/**
+ * Sources: each knows its size and can send elements [begin, end) on
+ */
+template <typename Type>
+struct IotaSource
+{
+	using value_type = Type;
+
+	Type start;
+	std::size_t count;
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	template <typename Sink>
+	void run(std::size_t begin, std::size_t end, Sink& sink) const
+	{
+		Type value = start + static_cast<Type>(begin);
+		for (std::size_t i = begin; i < end; i++, ++value)
+		{
+			sink(value);
+		}
+	}
+};
+
+template <typename Iterator>
+struct RangeSource
+{
+	using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+	Iterator first;
+	std::size_t count;
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	template <typename Sink>
+	void run(std::size_t begin, std::size_t end, Sink& sink) const
+	{
+		Iterator iterator = first + begin;
+		for (std::size_t i = begin; i < end; i++, ++iterator)
+		{
+			sink(*iterator);
+		}
+	}
+};
+
+template <typename Function>
+struct GenerateSource
+{
+	using value_type = std::decay_t<std::invoke_result_t<Function, std::size_t>>;
+
+	std::size_t count;
+	Function function;
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	template <typename Sink>
+	void run(std::size_t begin, std::size_t end, Sink& sink) const
+	{
+		for (std::size_t i = begin; i < end; i++)
+		{
+			sink(function(i));
+		}
+	}
+};
+
+
+/**
+ * The steps that do not change the elements: hand them straight on
+ */
+struct IdentityStage
+{
+	template <typename Sink>
+	Sink operator()(Sink sink) const
+	{
+		return sink;
+	}
+};
+
+
+template <typename Source, typename Stages, typename Value>
+class Pipeline
+{
+	Source source;
+	Stages stages;
+	unsigned threads;
+	std::size_t chunk;
+
+	/**
+	 * Runs the pipeline with one sink per chunk. make_sink(c) returns the
+	 * sink for chunk c; serially there is a single chunk.
+	 */
+	template <typename MakeSink>
+	void execute(std::size_t chunks, MakeSink make_sink) const
+	{
+		std::size_t size = source.size();
+		if (chunks <= 1)
+		{
+			auto sink = stages(make_sink(0));
+			source.run(0, size, sink);
+			return;
+		}
+
+		std::atomic<std::size_t> next(0);
+		auto work = [&] ()
+		{
+			for (std::size_t c = next++; c < chunks; c = next++)
+			{
+				auto sink = stages(make_sink(c));
+				std::size_t end = (c + 1) * chunk < size ? (c + 1) * chunk : size;
+				source.run(c * chunk, end, sink);
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < threads; t++)
+		{
+			workers.emplace_back(work);
+		}
+		work();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	std::size_t chunk_count() const
+	{
+		if (threads <= 1 || source.size() <= chunk)
+		{
+			return 1;
+		}
+		return (source.size() + chunk - 1) / chunk;
+	}
+
+	template <typename NewStage, typename NewValue>
+	Pipeline<Source, NewStage, NewValue> with(NewStage stage) const
+	{
+		return Pipeline<Source, NewStage, NewValue>(source, stage, threads, chunk);
+	}
+
+	public:
+	using value_type = Value;
+
+	Pipeline(Source source, Stages stages, unsigned threads = 1,
+			std::size_t chunk = 1 << 16) :
+		source(source), stages(stages), threads(threads),
+		chunk(chunk > 0 ? chunk : 1) {}
+
+	/**
+	 * Opt in to running on threads; chunk is how many source elements a
+	 * thread takes at a time
+	 */
+	Pipeline parallel(unsigned threads = std::thread::hardware_concurrency(),
+			std::size_t chunk = 1 << 16) const
+	{
+		return Pipeline(source, stages, threads > 0 ? threads : 1, chunk);
+	}
+
+	template <typename Function>
+	auto map(Function function) const
+	{
+		using Result = std::decay_t<std::invoke_result_t<Function&, const Value&>>;
+		Stages before = stages;
+		auto stage = [before, function] (auto sink)
+		{
+			return before([function, sink] (const Value& value) mutable
+				{
+					sink(function(value));
+				});
+		};
+		return with<decltype(stage), Result>(stage);
+	}
+
+	template <typename Predicate>
+	auto filter(Predicate predicate) const
+	{
+		Stages before = stages;
+		auto stage = [before, predicate] (auto sink)
+		{
+			return before([predicate, sink] (const Value& value) mutable
+				{
+					if (predicate(value))
+					{
+						sink(value);
+					}
+				});
+		};
+		return with<decltype(stage), Value>(stage);
+	}
+
+	template <typename Function>
+	void for_each(Function function) const
+	{
+		execute(chunk_count(), [&function] (std::size_t)
+			{
+				return [&function] (const Value& value) { function(value); };
+			});
+	}
+
+	std::vector<Value> to_vector() const
+	{
+		std::size_t chunks = chunk_count();
+		std::vector<Value> result;
+		if (chunks <= 1)
+		{
+			execute(1, [&result] (std::size_t)
+				{
+					return [&result] (const Value& value) { result.push_back(value); };
+				});
+			return result;
+		}
+
+		std::vector<std::vector<Value>> parts(chunks);
+		execute(chunks, [&parts] (std::size_t c)
+			{
+				std::vector<Value>* part = &parts[c];
+				return [part] (const Value& value) { part->push_back(value); };
+			});
+
+		std::size_t total = 0;
+		for (const std::vector<Value>& part : parts)
+		{
+			total += part.size();
+		}
+		result.reserve(total);
+		for (const std::vector<Value>& part : parts)
+		{
+			result.insert(std::end(result), std::begin(part), std::end(part));
+		}
+		return result;
+	}
+
+	/**
+	 * Combines the elements with operation starting from identity, which
+	 * each chunk also starts from when running in parallel. The chunks'
+	 * results are joined with combine, which is operation itself when the
+	 * elements and the result have the same type.
+	 */
+	template <typename Result, typename Operation>
+	Result reduce(Result identity, Operation operation) const
+	{
+		return reduce(identity, operation, operation);
+	}
+
+	template <typename Result, typename Operation, typename Combine>
+	Result reduce(Result identity, Operation operation, Combine combine) const
+	{
+		std::vector<Result> parts(chunk_count(), identity);
+		execute(parts.size(), [&parts, &operation] (std::size_t c)
+			{
+				Result* part = &parts[c];
+				return [part, &operation] (const Value& value)
+				{
+					*part = operation(*part, value);
+				};
+			});
+
+		Result total = parts[0];
+		for (std::size_t c = 1; c < parts.size(); c++)
+		{
+			total = combine(total, parts[c]);
+		}
+		return total;
+	}
+
+	/**
+	 * Sum of the elements in a long long for integers, in Value otherwise
+	 */
+	auto sum() const
+	{
+		using Total = std::conditional_t<std::is_integral<Value>::value,
+			long long, Value>;
+		return reduce(Total(), [] (const Total& total, const auto& value)
+			{
+				return total + value;
+			});
+	}
+
+	std::size_t count() const
+	{
+		return reduce(std::size_t(0), [] (std::size_t total, const Value&)
+			{
+				return total + 1;
+			}, std::plus<std::size_t>());
+	}
+};
+
+
+/**
+ * start, start + 1, ..., last - 1
+ */
+template <typename Type>
+Pipeline<IotaSource<Type>, IdentityStage, Type> stream_iota(Type start, Type last)
+{
+	std::size_t count = last > start ? static_cast<std::size_t>(last - start) : 0;
+	return {IotaSource<Type> {start, count}, IdentityStage()};
+}
+
+/**
+ * The elements of a random access range, which must outlive the pipeline
+ */
+template <typename Iterator>
+Pipeline<RangeSource<Iterator>, IdentityStage,
+	typename std::iterator_traits<Iterator>::value_type>
+stream_from(Iterator first, Iterator last)
+{
+	return {RangeSource<Iterator> {first, static_cast<std::size_t>(last - first)},
+		IdentityStage()};
+}
+
+template <typename Container>
+auto stream_from(const Container& container)
+{
+	return stream_from(std::begin(container), std::end(container));
+}
+
+/**
+ * function(0), function(1), ..., function(count - 1)
+ */
+template <typename Function>
+Pipeline<GenerateSource<Function>, IdentityStage,
+	typename GenerateSource<Function>::value_type>
+stream_generate(std::size_t count, Function function)
+{
+	return {GenerateSource<Function> {count, function}, IdentityStage()};
+}
+
+#endif
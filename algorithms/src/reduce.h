@@ -0,0 +1,561 @@
+#ifndef REDUCE_H_
+#define REDUCE_H_
+
+#include <vector>
+#include <thread>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	Adding up a sequence with one running total makes every addition wait
+ *	for the one before it, and with an int total the result silently wraps
+ *	around once it passes two billion.
+ *
+ *	Every reduction here is described by an operation with
+ *	- an Accumulator type, which may be wider than the elements,
+ *	- identity(), the accumulator of an empty sequence,
+ *	- add(accumulator, value) to take in one element,
+ *	- merge(accumulator, other) to combine two partial results,
+ *	- result(accumulator) to produce the final value.
+ *	merge must be associative, so partial results can be formed in any
+ *	grouping. reduce_with keeps four accumulators and feeds them elements in
+ *	turn, which gives the processor four independent chains to overlap;
+ *	parallel_reduce gives each thread a chunk and merges the threads'
+ *	accumulators pairwise, as a tree.
+ *
+ *	An operation may also provide kernel(data, size, accumulator) for
+ *	contiguous data; Sum does so with AVX2 for int, float and double,
+ *	widening each element before adding it.
+ *
+ *	Floating point addition is not associative, and long sums lose the
+ *	low bits of small terms. KahanSum carries the lost bits along in a
+ *	second accumulator, and pairwise_sum adds in a balanced tree so the
+ *	rounding error grows with log n instead of n.
+ */
+
+/**
+ * The type a sum of Type is accumulated in
+ */
+template <typename Type, typename = void>
+struct wide_type
+{
+	using type = Type;
+};
+
+template <typename Type>
+struct wide_type<Type, std::enable_if_t<std::is_integral<Type>::value>>
+{
+	using type = std::conditional_t<std::is_signed<Type>::value,
+		long long, unsigned long long>;
+};
+
+template <>
+struct wide_type<float>
+{
+	using type = double;
+};
+
+
+namespace reduce_detail
+{
+	template <typename Operation, typename = void>
+	struct has_kernel : std::false_type {};
+
+	template <typename Operation>
+	struct has_kernel<Operation, std::void_t<decltype(std::declval<const Operation&>()
+			.kernel(std::declval<const typename Operation::Value*>(), std::size_t(),
+				std::declval<typename Operation::Accumulator&>()))>>
+		: std::true_type {};
+
+	/**
+	 * Feeds the elements to four accumulators in turn and merges them
+	 */
+	template <typename Iterator, typename Operation>
+	typename Operation::Accumulator reduce_lanes(Iterator first, Iterator last,
+			const Operation& operation)
+	{
+		using Accumulator = typename Operation::Accumulator;
+		using Category = typename std::iterator_traits<Iterator>::iterator_category;
+
+		Accumulator lanes[4] = {operation.identity(), operation.identity(),
+			operation.identity(), operation.identity()};
+		if constexpr (std::is_base_of<std::random_access_iterator_tag,
+				Category>::value)
+		{
+			for (; last - first >= 4; first += 4)
+			{
+				operation.add(lanes[0], first[0]);
+				operation.add(lanes[1], first[1]);
+				operation.add(lanes[2], first[2]);
+				operation.add(lanes[3], first[3]);
+			}
+		}
+		for (; first != last; ++first)
+		{
+			operation.add(lanes[0], *first);
+		}
+
+		operation.merge(lanes[0], lanes[1]);
+		operation.merge(lanes[2], lanes[3]);
+		operation.merge(lanes[0], lanes[2]);
+		return lanes[0];
+	}
+}
+
+
+/**
+ * The accumulator of [first, last) under operation
+ */
+template <typename Iterator, typename Operation>
+typename Operation::Accumulator accumulate_with(Iterator first, Iterator last,
+		const Operation& operation)
+{
+	if constexpr (std::is_pointer<Iterator>::value
+			&& reduce_detail::has_kernel<Operation>::value)
+	{
+		typename Operation::Accumulator accumulator = operation.identity();
+		operation.kernel(first, last - first, accumulator);
+		return accumulator;
+	}
+	else
+	{
+		return reduce_detail::reduce_lanes(first, last, operation);
+	}
+}
+
+
+template <typename Iterator, typename Operation>
+auto reduce_with(Iterator first, Iterator last, const Operation& operation)
+{
+	return operation.result(accumulate_with(first, last, operation));
+}
+
+
+/**
+ * reduce_with over threads: random access ranges are cut into one chunk per
+ * thread and the chunks' accumulators are merged as a tree, pairs first
+ */
+template <typename Iterator, typename Operation>
+auto parallel_reduce(Iterator first, Iterator last, const Operation& operation,
+		unsigned threads = std::thread::hardware_concurrency())
+{
+	using Accumulator = typename Operation::Accumulator;
+
+	std::size_t size = last - first;
+	constexpr std::size_t MIN_CHUNK = 1 << 15;
+	if (threads > size / MIN_CHUNK)
+	{
+		threads = static_cast<unsigned>(size / MIN_CHUNK);
+	}
+	if (threads <= 1)
+	{
+		return reduce_with(first, last, operation);
+	}
+
+	std::vector<Accumulator> partial(threads, operation.identity());
+	auto work = [&] (unsigned t)
+	{
+		partial[t] = accumulate_with(first + size * t / threads,
+				first + size * (t + 1) / threads, operation);
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 1; t < threads; t++)
+	{
+		workers.emplace_back(work, t);
+	}
+	work(0);
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	for (unsigned step = 1; step < threads; step *= 2)
+	{
+		for (unsigned t = 0; t + step < threads; t += 2 * step)
+		{
+			operation.merge(partial[t], partial[t + step]);
+		}
+	}
+	return operation.result(partial[0]);
+}
+
+
+/**
+ * Sum in a type wide enough not to overflow: long long for integers,
+ * double for float
+ */
+template <typename Type>
+struct Sum
+{
+	using Value = Type;
+	using Accumulator = typename wide_type<Type>::type;
+
+	Accumulator identity() const
+	{
+		return Accumulator();
+	}
+
+	void add(Accumulator& total, const Type& value) const
+	{
+		total += value;
+	}
+
+	void merge(Accumulator& total, const Accumulator& other) const
+	{
+		total += other;
+	}
+
+	Accumulator result(const Accumulator& total) const
+	{
+		return total;
+	}
+
+	void kernel(const Type* data, std::size_t size, Accumulator& total) const
+	{
+		std::size_t i = 0;
+#if defined(__AVX2__)
+		if constexpr (std::is_same<Type, int>::value)
+		{
+			// Two registers of four 64 bit totals each, eight ints per step
+			__m256i low = _mm256_setzero_si256(), high = _mm256_setzero_si256();
+			for (; i + 8 <= size; i += 8)
+			{
+				__m256i block = _mm256_loadu_si256(
+						reinterpret_cast<const __m256i*>(data + i));
+				low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(
+							_mm256_castsi256_si128(block)));
+				high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(
+							_mm256_extracti128_si256(block, 1)));
+			}
+			alignas(32) long long lanes[4];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes),
+					_mm256_add_epi64(low, high));
+			total += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		}
+		else if constexpr (std::is_same<Type, float>::value
+				|| std::is_same<Type, double>::value)
+		{
+			// Four registers of doubles keep four addition chains going
+			__m256d lanes[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(),
+				_mm256_setzero_pd(), _mm256_setzero_pd()};
+			for (; i + 16 <= size; i += 16)
+			{
+				for (int r = 0; r < 4; r++)
+				{
+					if constexpr (std::is_same<Type, float>::value)
+					{
+						lanes[r] = _mm256_add_pd(lanes[r],
+								_mm256_cvtps_pd(_mm_loadu_ps(data + i + 4 * r)));
+					}
+					else
+					{
+						lanes[r] = _mm256_add_pd(lanes[r],
+								_mm256_loadu_pd(data + i + 4 * r));
+					}
+				}
+			}
+			alignas(32) double parts[4];
+			_mm256_store_pd(parts, _mm256_add_pd(_mm256_add_pd(lanes[0], lanes[1]),
+						_mm256_add_pd(lanes[2], lanes[3])));
+			total += (parts[0] + parts[1]) + (parts[2] + parts[3]);
+		}
+#endif
+		merge(total, reduce_detail::reduce_lanes(data + i, data + size, *this));
+	}
+};
+
+
+/**
+ * Compensated (Kahan-Babuska) summation: the low order bits lost by each
+ * addition are added back at the end
+ */
+template <typename Type>
+struct KahanSum
+{
+	using Value = Type;
+
+	struct Accumulator
+	{
+		double sum = 0;
+		double compensation = 0;
+	};
+
+	Accumulator identity() const
+	{
+		return Accumulator();
+	}
+
+	static void add_term(Accumulator& total, double value)
+	{
+		double sum = total.sum + value;
+		if (std::abs(total.sum) >= std::abs(value))
+		{
+			total.compensation += (total.sum - sum) + value;
+		}
+		else
+		{
+			total.compensation += (value - sum) + total.sum;
+		}
+		total.sum = sum;
+	}
+
+	void add(Accumulator& total, const Type& value) const
+	{
+		add_term(total, value);
+	}
+
+	void merge(Accumulator& total, const Accumulator& other) const
+	{
+		add_term(total, other.sum);
+		total.compensation += other.compensation;
+	}
+
+	double result(const Accumulator& total) const
+	{
+		return total.sum + total.compensation;
+	}
+};
+
+
+/**
+ * Smallest and largest elements. The result of an empty range is the
+ * identity: the largest Type for Min, the lowest for Max.
+ */
+template <typename Type>
+struct Min
+{
+	using Value = Type;
+	using Accumulator = Type;
+
+	Type identity() const
+	{
+		return std::numeric_limits<Type>::has_infinity
+			? std::numeric_limits<Type>::infinity()
+			: std::numeric_limits<Type>::max();
+	}
+
+	void add(Type& least, const Type& value) const
+	{
+		least = value < least ? value : least;
+	}
+
+	void merge(Type& least, const Type& other) const
+	{
+		add(least, other);
+	}
+
+	Type result(const Type& least) const
+	{
+		return least;
+	}
+};
+
+template <typename Type>
+struct Max
+{
+	using Value = Type;
+	using Accumulator = Type;
+
+	Type identity() const
+	{
+		return std::numeric_limits<Type>::has_infinity
+			? -std::numeric_limits<Type>::infinity()
+			: std::numeric_limits<Type>::lowest();
+	}
+
+	void add(Type& most, const Type& value) const
+	{
+		most = most < value ? value : most;
+	}
+
+	void merge(Type& most, const Type& other) const
+	{
+		add(most, other);
+	}
+
+	Type result(const Type& most) const
+	{
+		return most;
+	}
+};
+
+
+/**
+ * Count, mean, variance, minimum and maximum in one pass. Means and
+ * variances are updated incrementally (Welford) and partial results are
+ * combined with Chan's formula, so no large sums of squares are formed.
+ */
+template <typename Type>
+struct Statistics
+{
+	using Value = Type;
+
+	struct Accumulator
+	{
+		std::size_t count = 0;
+		double mean = 0;
+		double m2 = 0;
+		double min = std::numeric_limits<double>::infinity();
+		double max = -std::numeric_limits<double>::infinity();
+	};
+
+	struct Summary
+	{
+		std::size_t count;
+		double mean;
+		double variance;
+		double min;
+		double max;
+	};
+
+	Accumulator identity() const
+	{
+		return Accumulator();
+	}
+
+	void add(Accumulator& stats, const Type& item) const
+	{
+		double value = static_cast<double>(item);
+		stats.count++;
+		double delta = value - stats.mean;
+		stats.mean += delta / stats.count;
+		stats.m2 += delta * (value - stats.mean);
+		stats.min = value < stats.min ? value : stats.min;
+		stats.max = value > stats.max ? value : stats.max;
+	}
+
+	void merge(Accumulator& stats, const Accumulator& other) const
+	{
+		if (other.count == 0)
+		{
+			return;
+		}
+		std::size_t count = stats.count + other.count;
+		double delta = other.mean - stats.mean;
+		stats.mean += delta * other.count / count;
+		stats.m2 += other.m2
+			+ delta * delta * stats.count / count * other.count;
+		stats.count = count;
+		stats.min = std::min(stats.min, other.min);
+		stats.max = std::max(stats.max, other.max);
+	}
+
+	Summary result(const Accumulator& stats) const
+	{
+		return Summary {stats.count, stats.mean,
+			stats.count > 1 ? stats.m2 / (stats.count - 1) : 0.0,
+			stats.min, stats.max};
+	}
+};
+
+
+/**
+ * A reduction from any associative binary operation and its identity,
+ * such as std::multiplies<long long>() with 1 or std::bit_or<unsigned>()
+ * with 0
+ */
+template <typename Type, typename BinaryOperation>
+struct Reduction
+{
+	using Value = Type;
+	using Accumulator = Type;
+
+	Type zero;
+	BinaryOperation operation;
+
+	Type identity() const
+	{
+		return zero;
+	}
+
+	void add(Type& total, const Type& value) const
+	{
+		total = operation(total, value);
+	}
+
+	void merge(Type& total, const Type& other) const
+	{
+		total = operation(total, other);
+	}
+
+	Type result(const Type& total) const
+	{
+		return total;
+	}
+};
+
+template <typename Type, typename BinaryOperation>
+Reduction<Type, BinaryOperation> make_reduction(Type identity,
+		BinaryOperation operation)
+{
+	return Reduction<Type, BinaryOperation> {identity, operation};
+}
+
+
+/**
+ * Convenience functions for the common reductions. The sum is named for
+ * its widened total so that it does not clash with a local named sum.
+ */
+template <typename Iterator>
+auto widening_sum(Iterator first, Iterator last)
+{
+	using Type = typename std::iterator_traits<Iterator>::value_type;
+	return reduce_with(first, last, Sum<Type>());
+}
+
+template <typename Type, typename Allocator>
+auto widening_sum(const std::vector<Type, Allocator>& values)
+{
+	return widening_sum(values.data(), values.data() + values.size());
+}
+
+template <typename Iterator>
+auto statistics(Iterator first, Iterator last)
+{
+	using Type = typename std::iterator_traits<Iterator>::value_type;
+	return reduce_with(first, last, Statistics<Type>());
+}
+
+
+/**
+ * Sum of data[0 .. size) added as a balanced tree of halves; the blocks at
+ * the leaves are summed with four accumulators
+ */
+template <typename Type>
+double pairwise_sum(const Type* data, std::size_t size)
+{
+	constexpr std::size_t LEAF = 256;
+	if (size <= LEAF)
+	{
+		double lanes[4] = {0, 0, 0, 0};
+		std::size_t i = 0;
+		for (; i + 4 <= size; i += 4)
+		{
+			lanes[0] += data[i];
+			lanes[1] += data[i + 1];
+			lanes[2] += data[i + 2];
+			lanes[3] += data[i + 3];
+		}
+		for (; i < size; i++)
+		{
+			lanes[0] += data[i];
+		}
+		return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	}
+	std::size_t half = size / 2;
+	return pairwise_sum(data, half) + pairwise_sum(data + half, size - half);
+}
+
+#endif
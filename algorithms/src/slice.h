@@ -0,0 +1,239 @@
+#ifndef SLICE_H_
+#define SLICE_H_
+
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	Taking part of a vector by constructing a new vector and copying the
+ *	elements over costs an allocation and a pass over the elements every
+ *	time. A Slice is only a pointer and a length into memory that belongs
+ *	to someone else, so head, tail, drop, take and window are O(1) and
+ *	copy nothing. Call to_vector() when an owning copy is really needed.
+ *
+ *	Counts larger than the slice are clamped: take(10) of 4 elements is
+ *	all 4 of them, drop(10) is empty.
+ *
+ *	A Slice does not keep its container alive, and it goes stale when the
+ *	container reallocates (push_back past capacity, reserve, shrink) or
+ *	shrinks below the slice. In debug builds (NDEBUG not defined) a slice
+ *	of a container remembers where the container's elements were and how
+ *	many there were, and every access asserts that they still are. This
+ *	catches reallocation and shrinking; a container that has been
+ *	destroyed cannot be detected this way.
+ */
+template <typename Type>
+class Slice;
+
+template <typename Type>
+struct is_slice : std::false_type {};
+
+template <typename Type>
+struct is_slice<Slice<Type>> : std::true_type {};
+
+
+template <typename Type>
+class Slice
+{
+	template <typename Other>
+	friend class Slice;
+
+	Type* first;
+	std::size_t length;
+
+#ifndef NDEBUG
+	// The container sliced, a way to ask it where its elements are and
+	// how many, and where they were when the slice was made
+	const void* owner = nullptr;
+	const void* (*owner_data)(const void*) = nullptr;
+	std::size_t (*owner_size)(const void*) = nullptr;
+	const void* owner_begin = nullptr;
+#endif
+
+	void check() const
+	{
+#ifndef NDEBUG
+		if (owner)
+		{
+			assert(owner_data(owner) == owner_begin
+					&& "slice used after its container reallocated");
+			assert(static_cast<std::size_t>(first
+						- static_cast<const Type*>(owner_begin)) + length
+					<= owner_size(owner)
+					&& "slice used after its container shrank");
+		}
+#endif
+	}
+
+	Slice sub(std::size_t offset, std::size_t count) const
+	{
+		Slice result = *this;
+		result.first = first + offset;
+		result.length = count;
+		return result;
+	}
+
+	public:
+	using value_type = std::remove_cv_t<Type>;
+	using iterator = Type*;
+	using reference = Type&;
+
+	Slice() : first(nullptr), length(0) {}
+
+	Slice(Type* first, std::size_t length) : first(first), length(length) {}
+
+	/**
+	 * A slice of a whole contiguous container: std::vector, std::array,
+	 * std::string or anything else with data() and size()
+	 */
+	template <typename Container, typename = std::enable_if_t<
+		!is_slice<std::remove_cv_t<Container>>::value
+		&& std::is_convertible<decltype(std::declval<Container&>().data()),
+			Type*>::value>>
+	Slice(Container& container) :
+		first(container.data()), length(container.size())
+	{
+#ifndef NDEBUG
+		owner = &container;
+		owner_data = [] (const void* c) -> const void*
+		{
+			return static_cast<const Container*>(c)->data();
+		};
+		owner_size = [] (const void* c) -> std::size_t
+		{
+			return static_cast<const Container*>(c)->size();
+		};
+		owner_begin = first;
+#endif
+	}
+
+	template <std::size_t Size>
+	Slice(Type (&array)[Size]) : first(array), length(Size) {}
+
+	// A slice of Type converts to a slice of const Type
+	template <typename Other, typename = std::enable_if_t<
+		std::is_convertible<Other*, Type*>::value>>
+	Slice(const Slice<Other>& other) : first(other.first), length(other.length)
+	{
+#ifndef NDEBUG
+		owner = other.owner;
+		owner_data = other.owner_data;
+		owner_size = other.owner_size;
+		owner_begin = other.owner_begin;
+#endif
+	}
+
+	Type* begin() const
+	{
+		check();
+		return first;
+	}
+
+	Type* end() const
+	{
+		return first + length;
+	}
+
+	Type* data() const
+	{
+		check();
+		return first;
+	}
+
+	std::size_t size() const
+	{
+		return length;
+	}
+
+	bool empty() const
+	{
+		return length == 0;
+	}
+
+	Type& operator[](std::size_t index) const
+	{
+		assert(index < length && "slice index out of range");
+		check();
+		return first[index];
+	}
+
+	Type& front() const
+	{
+		return (*this)[0];
+	}
+
+	Type& back() const
+	{
+		return (*this)[length - 1];
+	}
+
+	/**
+	 * The first count elements; take is another name for it
+	 */
+	Slice head(std::size_t count) const
+	{
+		return sub(0, count < length ? count : length);
+	}
+
+	Slice take(std::size_t count) const
+	{
+		return head(count);
+	}
+
+	/**
+	 * The last count elements
+	 */
+	Slice tail(std::size_t count) const
+	{
+		count = count < length ? count : length;
+		return sub(length - count, count);
+	}
+
+	/**
+	 * Everything but the first count elements
+	 */
+	Slice drop(std::size_t count) const
+	{
+		count = count < length ? count : length;
+		return sub(count, length - count);
+	}
+
+	/**
+	 * Everything but the last count elements
+	 */
+	Slice drop_last(std::size_t count) const
+	{
+		return sub(0, count < length ? length - count : 0);
+	}
+
+	/**
+	 * count elements starting at offset, or as many as there are
+	 */
+	Slice window(std::size_t offset, std::size_t count) const
+	{
+		return drop(offset).take(count);
+	}
+
+	std::vector<value_type> to_vector() const
+	{
+		check();
+		return std::vector<value_type>(first, first + length);
+	}
+};
+
+
+/**
+ * Slice of a container or array, read only when the container is const
+ */
+template <typename Container>
+auto slice(Container& container)
+{
+	using Type = std::remove_pointer_t<decltype(std::data(container))>;
+	return Slice<Type>(container);
+}
+
+#endif
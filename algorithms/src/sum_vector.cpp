@@ -1,6 +1,9 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <functional>
+
+#include "reduce.h"
 
 int main()
 {
@@ -9,4 +12,16 @@ int main()
 	std::for_each(std::begin(elements), std::end(elements), 
 			[&sum] (int x) { sum += x;});
 	std::cout << "The sum is " << sum << "\n";
+
+	// An int total wraps past 2147483647; widening_sum adds in long long
+	std::vector<int> large(4, 2000000000);
+	std::cout << "The sum of the large values is " << widening_sum(large) << "\n";
+
+	// Other reductions come from the same engine
+	auto stats = statistics(std::begin(elements), std::end(elements));
+	std::cout << "mean " << stats.mean << ", variance " << stats.variance
+		<< ", min " << stats.min << ", max " << stats.max << "\n";
+	std::cout << "product " << reduce_with(std::begin(elements),
+			std::end(elements), make_reduction(1LL, std::multiplies<long long>()))
+		<< "\n";
 }
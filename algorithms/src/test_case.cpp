@@ -0,0 +1,52 @@
+#include <iostream>
+#include <string>
+
+#include "case_convert.h"
+
+/**
+ * Uppercases text holding an invalid sequence at offset and checks that
+ * exactly the bytes before it are converted, whichever kernel is built
+ */
+bool check_invalid(std::size_t offset, std::size_t size)
+{
+	std::string text(size, 'a');
+	text[offset] = '\xC0';
+	text[offset + 1] = '\x80';
+
+	std::string expected = text;
+	for (std::size_t i = 0; i < offset; i++)
+	{
+		expected[i] = 'A';
+	}
+
+	bool valid = to_upper(text);
+	bool correct = !valid && text == expected;
+	std::cout << "invalid at " << offset << " of " << size << ": "
+		<< (correct ? "ok" : "WRONG") << "\n";
+	return correct;
+}
+
+
+int main()
+{
+	std::string text = "abc\xC0\x80xyz";
+	bool valid = to_upper(text);
+	bool correct = !valid && text == "ABC\xC0\x80xyz";
+	std::cout << "\"abc\\xC0\\x80xyz\": " << (correct ? "ok" : "WRONG") << "\n";
+
+	// Inside the first block of the 8, 32 and 64 byte kernels, and in a
+	// later one
+	for (std::size_t offset : {3, 6, 20, 40, 70, 100})
+	{
+		correct = check_invalid(offset, 128) && correct;
+	}
+
+	std::string greek = "hello, \xCE\xB1\xCE\xB2\xCE\xB3 world";
+	correct = to_upper(greek) && greek == "HELLO, \xCE\x91\xCE\x92\xCE\x93 WORLD"
+		&& correct;
+	std::cout << "Greek: " << (greek == "HELLO, \xCE\x91\xCE\x92\xCE\x93 WORLD"
+			? "ok" : "WRONG") << "\n";
+
+	std::cout << (correct ? "All passed\n" : "FAILED\n");
+	return correct ? 0 : 1;
+}
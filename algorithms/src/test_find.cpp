@@ -3,13 +3,15 @@
 #include <algorithm>
 #include <numeric>
 
+#include "fast_find.h"
+
 int main()
 {
 	std::vector<int> sequence(1000, 0);
 	std::iota(std::begin(sequence), std::end(sequence), 0);
 
 	// Look for 567
-	auto iter = std::find(std::begin(sequence), std::end(sequence), 567);
+	auto iter = find_value(sequence, 567);
 	if (iter != std::end(sequence))
 	{
 		std::cout << *iter << " is present" << "\n";
@@ -20,7 +22,7 @@ int main()
 	}
 
 	// Look for -200
-	iter = std::find(std::begin(sequence), std::end(sequence), -200);
+	iter = find_value(sequence, -200);
 	if (iter != std::end(sequence))
 	{
 		std::cout << *iter << " is present" << "\n";
@@ -29,4 +31,15 @@ int main()
 	{
 		std::cout << "-200 is not present" << "\n";
 	}
+
+	// For many lookups in the same sequence, build an index once
+	EytzingerIndex<int> index(std::begin(sequence), std::end(sequence));
+	std::vector<int> queries {567, -200, 999, 1000};
+	bool found[4];
+	index.contains(queries.data(), queries.size(), found);
+	for (std::size_t i = 0; i < queries.size(); i++)
+	{
+		std::cout << queries[i] << (found[i] ? " is present" : " is not present")
+			<< "\n";
+	}
 }
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <numeric>
 
+#include "pipeline.h"
+
 int main()
 {
 	const int SIZE = 20;
@@ -37,4 +39,19 @@ int main()
 			[] (int x) {std::cout << x << " ";});
 	std::cout << "\n";
 
+	// The same doubled sequence as one lazy pipeline: no vectors are
+	// filled, each value is generated, doubled and printed in turn
+	stream_iota(0, SIZE)
+		.map([] (int x) {return 2 * x;})
+		.for_each([] (int x) {std::cout << x << " ";});
+	std::cout << "\n";
+
+	// Only materialise when a container is really needed
+	std::vector<int> multiplesOfSix = stream_iota(0, SIZE)
+		.map([] (int x) {return 2 * x;})
+		.filter([] (int x) {return x % 3 == 0;})
+		.to_vector();
+	std::for_each(std::begin(multiplesOfSix), std::end(multiplesOfSix), 
+			[] (int x) {std::cout << x << " ";});
+	std::cout << "\n";
 }
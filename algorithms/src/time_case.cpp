@@ -0,0 +1,72 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "case_convert.h"
+#include "timing.h"
+
+/**
+ * Repeats sample until the text is size bytes long
+ */
+std::string make_text(const std::string& sample, std::size_t size)
+{
+	std::string text;
+	text.reserve(size + sample.size());
+	while (text.size() < size)
+	{
+		text += sample;
+	}
+	return text;
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 256 * 1024 * 1024;
+	std::string ascii = make_text("The quick brown fox jumps over the lazy dog. ", size);
+	std::string mixed = make_text("Jambo rafiki, Привет мир, Grüße aus Köln. ", size);
+
+	std::string text = ascii;
+	double transform_time = time_msec([&] ()
+		{
+			std::transform(std::begin(text), std::end(text), std::begin(text),
+					[] (unsigned char c) { return std::toupper(c); });
+		});
+	std::string expected = text;
+
+	text = ascii;
+	double ascii_time = time_msec([&] () { ascii_to_upper(text); });
+	bool ascii_same = text == expected;
+
+	text = ascii;
+	double utf8_time = time_msec([&] () { to_upper(text); });
+	bool utf8_same = text == expected;
+
+	text = mixed;
+	double mixed_time = time_msec([&] () { to_upper(text); });
+
+	// Streaming in 64 KiB pieces, as when reading a file block by block
+	std::string streamed;
+	streamed.reserve(mixed.size());
+	double stream_time = time_msec([&] ()
+		{
+			CaseConvertStream stream(true);
+			for (std::size_t i = 0; i < mixed.size(); i += 1 << 16)
+			{
+				stream.convert(std::string_view(mixed).substr(i, 1 << 16), streamed);
+			}
+			stream.finish();
+		});
+
+	std::cout << size / (1024 * 1024) << " MiB of text, uppercased\n";
+	std::cout << "std::transform + toupper (ASCII): " << transform_time << " msec\n";
+	std::cout << "ascii_to_upper (ASCII):           " << ascii_time << " msec"
+		<< (ascii_same ? "" : "    MISMATCH") << "\n";
+	std::cout << "to_upper (ASCII):                 " << utf8_time << " msec"
+		<< (utf8_same ? "" : "    MISMATCH") << "\n";
+	std::cout << "to_upper (mixed UTF-8):           " << mixed_time << " msec\n";
+	std::cout << "CaseConvertStream (mixed UTF-8):  " << stream_time << " msec"
+		<< (streamed == text ? "" : "    MISMATCH") << "\n";
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdlib>
+
+#include "filter.h"
+#include "timing.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 64 * 1024 * 1024;
+	unsigned threads = argc > 2 ? std::atoi(argv[2])
+		: std::max(2u, std::thread::hardware_concurrency());
+
+	std::vector<int> sequence(size);
+	unsigned state = 12345;
+	for (int& value : sequence)
+	{
+		state = state * 1103515245 + 12345;
+		value = static_cast<int>(state >> 8);
+	}
+	auto is_even = [] (int x) { return x % 2 == 0; };
+
+	std::size_t kept_twice = 0, kept_once = 0, kept_parallel = 0;
+	double twice = time_msec([&] ()
+		{
+			std::vector<int> evens(std::count_if(std::begin(sequence),
+					std::end(sequence), is_even));
+			std::copy_if(std::begin(sequence), std::end(sequence),
+					std::begin(evens), is_even);
+			kept_twice = evens.size();
+		});
+	double once = time_msec([&] ()
+		{
+			kept_once = filter(sequence, is_even).size();
+		});
+	double parallel = time_msec([&] ()
+		{
+			FilteredVector<int> evens;
+			evens.resize(size);
+			int* end = parallel_filter(sequence.data(),
+					sequence.data() + size, evens.data(), is_even, threads);
+			kept_parallel = end - evens.data();
+		});
+
+	std::cout << "Keeping the even values of " << size << " integers\n";
+	std::cout << "count_if + copy_if: " << twice << " msec (" << kept_twice << ")\n";
+	std::cout << "filter:             " << once << " msec (" << kept_once << ")\n";
+	std::cout << "parallel_filter (" << threads << " threads): " << parallel
+		<< " msec (" << kept_parallel << ")\n";
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <cstdlib>
+
+#include "fast_find.h"
+#include "timing.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 16 * 1024 * 1024;
+	std::size_t lookups = argc > 2 ? std::atoll(argv[2]) : 1000000;
+
+	// Even numbers only, so about half of the queries miss
+	std::vector<int> sequence(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		sequence[i] = static_cast<int>(2 * i);
+	}
+	std::vector<int> queries(lookups);
+	unsigned state = 2024;
+	for (int& query : queries)
+	{
+		state = state * 1103515245 + 12345;
+		query = static_cast<int>((state >> 4) % (2 * size));
+	}
+
+	// Linear search: a few queries are enough to compare
+	std::size_t linear = 20, hits_find = 0, hits_simd = 0;
+	double find_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < linear; i++)
+			{
+				hits_find += std::find(std::begin(sequence), std::end(sequence),
+						queries[i]) != std::end(sequence);
+			}
+		});
+	double simd_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < linear; i++)
+			{
+				hits_simd += find_value(sequence, queries[i]) != std::end(sequence);
+			}
+		});
+	std::cout << linear << " linear searches in " << size << " integers\n";
+	std::cout << "std::find:  " << find_time << " msec (" << hits_find << " found)\n";
+	std::cout << "find_value: " << simd_time << " msec (" << hits_simd << " found)\n\n";
+
+	// Repeated lookups: binary search against the index
+	std::size_t hits_binary = 0, hits_index = 0, hits_batch = 0;
+	double binary_time = time_msec([&] ()
+		{
+			for (int query : queries)
+			{
+				hits_binary += std::binary_search(std::begin(sequence),
+						std::end(sequence), query);
+			}
+		});
+
+	EytzingerIndex<int> index(std::begin(sequence), std::end(sequence));
+	double index_time = time_msec([&] ()
+		{
+			for (int query : queries)
+			{
+				hits_index += index.contains(query);
+			}
+		});
+
+	std::unique_ptr<bool[]> found(new bool[lookups]);
+	double batch_time = time_msec([&] ()
+		{
+			index.contains(queries.data(), lookups, found.get());
+			hits_batch = std::count(found.get(), found.get() + lookups, true);
+		});
+
+	std::cout << lookups << " lookups in " << size << " integers\n";
+	std::cout << "std::binary_search: " << binary_time << " msec ("
+		<< hits_binary << " found)\n";
+	std::cout << "EytzingerIndex:     " << index_time << " msec ("
+		<< hits_index << " found)\n";
+	std::cout << "batched:            " << batch_time << " msec ("
+		<< hits_batch << " found)\n";
+}
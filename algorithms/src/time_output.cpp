@@ -0,0 +1,63 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <cstdlib>
+
+#include "fast_output.h"
+#include "timing.h"
+
+/**
+ * Times writing a large sequence to standard output with
+ * std::ostream_iterator and with OutputBufferIterator. Run it with standard
+ * output sent to a file or /dev/null; the timings go to standard error.
+ *
+ *	./time_output 10000000 > /dev/null
+ */
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 10000000;
+	std::vector<int> integers(size);
+	std::iota(std::begin(integers), std::end(integers), -static_cast<int>(size / 2));
+	std::vector<double> reals(size);
+	std::transform(std::begin(integers), std::end(integers), std::begin(reals),
+			[] (int x) { return x / 7.0; });
+
+	bool written = true;
+	double stream_int = time_msec([&] ()
+		{
+			std::copy(std::begin(integers), std::end(integers),
+					std::ostream_iterator<int>(std::cout, "\n"));
+			std::cout << std::flush;
+		});
+	double buffer_int = time_msec([&] ()
+		{
+			OutputBuffer output;
+			std::copy(std::begin(integers), std::end(integers),
+					OutputBufferIterator<int>(output, "\n"));
+			written = output.flush() && written;
+		});
+
+	// std::cout prints 6 significant digits by default; ask for enough to
+	// read the same value back so both write the same information
+	std::cout.precision(17);
+	double stream_real = time_msec([&] ()
+		{
+			std::copy(std::begin(reals), std::end(reals),
+					std::ostream_iterator<double>(std::cout, "\n"));
+			std::cout << std::flush;
+		});
+	double buffer_real = time_msec([&] ()
+		{
+			OutputBuffer output;
+			std::copy(std::begin(reals), std::end(reals),
+					OutputBufferIterator<double>(output, "\n"));
+			written = output.flush() && written;
+		});
+
+	std::cerr << size << " values    ostream_iterator (msec)    OutputBuffer (msec)\n";
+	std::cerr << "int          " << stream_int << "        " << buffer_int << "\n";
+	std::cerr << "double       " << stream_real << "        " << buffer_real << "\n";
+	return written ? 0 : 1;
+}
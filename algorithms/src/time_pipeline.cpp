@@ -0,0 +1,65 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <cstdlib>
+
+#include "pipeline.h"
+#include "timing.h"
+
+int main(int argc, char* argv[])
+{
+	int size = argc > 1 ? std::atoi(argv[1]) : 64 * 1024 * 1024;
+	unsigned threads = argc > 2 ? std::atoi(argv[2])
+		: std::max(2u, std::thread::hardware_concurrency());
+
+	auto twice = [] (int x) { return 2 * x; };
+	auto keep = [] (int x) { return x % 3 == 0; };
+
+	// iota, copy, transform and filter through vectors, then a sum
+	long long staged = 0;
+	double staged_time = time_msec([&] ()
+		{
+			std::vector<int> sequence(size);
+			std::iota(std::begin(sequence), std::end(sequence), 0);
+			std::vector<int> sequenceTwo(size);
+			std::copy(std::begin(sequence), std::end(sequence),
+					std::begin(sequenceTwo));
+			std::vector<int> sequenceThree(size);
+			std::transform(std::begin(sequenceTwo), std::end(sequenceTwo),
+					std::begin(sequenceThree), twice);
+			std::vector<int> kept;
+			std::copy_if(std::begin(sequenceThree), std::end(sequenceThree),
+					std::back_inserter(kept), keep);
+			std::for_each(std::begin(kept), std::end(kept),
+					[&staged] (int x) { staged += x; });
+		});
+
+	long long fused = 0, parallel = 0;
+	double fused_time = time_msec([&] ()
+		{
+			fused = stream_iota(0, size).map(twice).filter(keep).sum();
+		});
+	double parallel_time = time_msec([&] ()
+		{
+			parallel = stream_iota(0, size).map(twice).filter(keep)
+				.parallel(threads).sum();
+		});
+
+	std::size_t materialised = 0;
+	double vector_time = time_msec([&] ()
+		{
+			materialised = stream_iota(0, size).map(twice).filter(keep)
+				.to_vector().size();
+		});
+
+	std::cout << "iota -> double -> keep multiples of 3 -> sum, " << size
+		<< " values\n";
+	std::cout << "vectors between steps: " << staged_time << " msec (" << staged << ")\n";
+	std::cout << "fused pipeline:        " << fused_time << " msec (" << fused << ")\n";
+	std::cout << "fused, " << threads << " threads:      " << parallel_time
+		<< " msec (" << parallel << ")\n";
+	std::cout << "fused into a vector:   " << vector_time << " msec ("
+		<< materialised << " values)\n";
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <cstdlib>
+
+#include "reduce.h"
+#include "timing.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 64 * 1024 * 1024;
+	unsigned threads = argc > 2 ? std::atoi(argv[2])
+		: std::max(2u, std::thread::hardware_concurrency());
+
+	std::vector<int> integers(size);
+	unsigned state = 7;
+	for (int& value : integers)
+	{
+		state = state * 1103515245 + 12345;
+		value = static_cast<int>(state);
+	}
+
+	int wrapped = 0;
+	long long accumulated = 0, summed = 0, parallel = 0;
+	double for_each_time = time_msec([&] ()
+		{
+			std::for_each(std::begin(integers), std::end(integers),
+					[&wrapped] (int x)
+					{
+						wrapped = static_cast<int>(static_cast<unsigned>(wrapped) + x);
+					});
+		});
+	double accumulate_time = time_msec([&] ()
+		{
+			accumulated = std::accumulate(std::begin(integers),
+					std::end(integers), 0LL);
+		});
+	double sum_time = time_msec([&] () { summed = widening_sum(integers); });
+	double parallel_time = time_msec([&] ()
+		{
+			parallel = parallel_reduce(integers.data(),
+					integers.data() + size, Sum<int>(), threads);
+		});
+
+	std::cout << "Sum of " << size << " integers\n";
+	std::cout << "for_each into int:        " << for_each_time << " msec ("
+		<< wrapped << ", wrapped)\n";
+	std::cout << "accumulate into long long: " << accumulate_time << " msec ("
+		<< accumulated << ")\n";
+	std::cout << "widening_sum:              " << sum_time << " msec ("
+		<< summed << ")\n";
+	std::cout << "parallel_reduce (" << threads << " threads): " << parallel_time
+		<< " msec (" << parallel << ")\n\n";
+
+	// One large value followed by many small ones: a plain running total
+	// drops the small ones' low bits
+	std::vector<double> reals(size, 0.1);
+	reals[0] = 1e15;
+	double exact = 1e15 + 0.1 * (size - 1);
+	double naive = 0, kahan = 0, pairwise = 0;
+	double naive_time = time_msec([&] ()
+		{
+			naive = std::accumulate(std::begin(reals), std::end(reals), 0.0);
+		});
+	double kahan_time = time_msec([&] ()
+		{
+			kahan = reduce_with(std::begin(reals), std::end(reals),
+					KahanSum<double>());
+		});
+	double pairwise_time = time_msec([&] ()
+		{
+			pairwise = pairwise_sum(reals.data(), size);
+		});
+
+	auto show = [] (const char* name, double value, double time)
+	{
+		std::cout << name << time << " msec, ";
+		std::cout.precision(17);
+		std::cout << value << "\n";
+		std::cout.precision(6);
+	};
+	show("exact:        ", exact, 0);
+	show("accumulate:   ", naive, naive_time);
+	show("KahanSum:     ", kahan, kahan_time);
+	show("pairwise_sum: ", pairwise, pairwise_time);
+}
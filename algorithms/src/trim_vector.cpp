@@ -1,6 +1,9 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <numeric>
+
+#include "slice.h"
 
 int main()
 {
@@ -9,15 +12,27 @@ int main()
 			[] (int x) {std::cout << x << " ";});
 	std::cout << "\n";
 
-	// Make a copy of sequence with the first and last elements trimmed off
-	if (sequence.size() >= 2)
-	{
-		std::vector<int> sequenceTwo(sequence.size() - 2);
-		std::copy(std::begin(sequence) + 1, std::end(sequence) - 1,
-				std::begin(sequenceTwo));
+	// View sequence with the first and last elements trimmed off; nothing
+	// is allocated or copied, and a sequence shorter than 2 gives an empty
+	// view
+	auto trimmed = slice(sequence).drop(1).drop_last(1);
+	std::for_each(std::begin(trimmed), std::end(trimmed),
+			[] (int x) {std::cout << x << " ";});
+	std::cout << "\n";
 
-		std::for_each(std::begin(sequenceTwo), std::end(sequenceTwo),
-				[] (int x) {std::cout << x << " ";});
-		std::cout << "\n";
+	// Sums of every window of three elements, again without copies
+	auto all = slice(sequence);
+	for (std::size_t i = 0; i + 3 <= all.size(); i++)
+	{
+		auto window = all.window(i, 3);
+		std::cout << std::accumulate(std::begin(window), std::end(window), 0)
+			<< " ";
 	}
+	std::cout << "\n";
+
+	// An owning copy only when it has to outlive or differ from sequence
+	std::vector<int> sequenceTwo = trimmed.to_vector();
+	sequence.push_back(7);
+	std::cout << "copy of the middle: " << sequenceTwo.size() << " elements, "
+		<< "head of the new sequence: " << slice(sequence).head(2).back() << "\n";
 }
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cctype>
 
+#include "case_convert.h"
+
 int main()
 {
 	std::string name = "Kamau", str = "abcDEF-GHIjkl345qw";
@@ -11,8 +13,17 @@ int main()
 	std::transform(std::begin(name), std::end(name), std::begin(name),
 			[] (unsigned char c) {return std::toupper(c);});
 	
-	std::transform(std::begin(str), std::end(str), std::begin(str),
-			[] (unsigned char c) {return std::toupper(c);});
+	// The same without a locale lookup per character
+	ascii_to_upper(str);
 	
 	std::cout << "After: " << name << "	" << str << "\n";
+
+	// Text that is not ASCII needs the UTF-8 aware conversion
+	std::string greeting = "Jambo, Привет, Γειά σου, Grüße";
+	if (to_upper(greeting))
+	{
+		std::cout << "Upper: " << greeting << "\n";
+	}
+	to_lower(greeting);
+	std::cout << "Lower: " << greeting << "\n";
 }
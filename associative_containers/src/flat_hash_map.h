@@ -0,0 +1,711 @@
+#ifndef FLAT_HASH_MAP_H_
+#define FLAT_HASH_MAP_H_
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	std::unordered_map and std::map allocate a node for every entry, and
+ *	a lookup follows pointers from node to node, usually missing the cache
+ *	each time. FlatHashMap keeps all entries in one array of slots and
+ *	resolves collisions by probing other slots of the same array (open
+ *	addressing), so an insertion allocates nothing unless the table grows.
+ *
+ *	Beside the slots there is one control byte per slot, laid out like
+ *	the Swiss tables of Abseil:
+ *	- EMPTY (0x80): never used since the table was last rebuilt
+ *	- DELETED (0xFE): erased; probing must carry on past it
+ *	- 0 .. 127: full, holding 7 bits of the key's hash
+ *	The other bits of the hash choose where probing starts. A lookup loads
+ *	16 control bytes at a time and compares all of them with the key's 7
+ *	bits in one SSE2 instruction (a plain loop without SSE2); only slots
+ *	whose byte matches have their key compared, so a lookup rarely looks
+ *	at more than one key. Probing stops at the first group with an EMPTY
+ *	byte.
+ *
+ *	The capacity is a power of two less one, and the table grows to double
+ *	its size when more than 7 slots in 8 would be used. The first 15
+ *	control bytes are repeated after the last one, so a group of 16 can be
+ *	loaded at any position without wrapping around.
+ *
+ *	The interface follows std::unordered_map: find, count, contains, at
+ *	(which throws std::out_of_range for a missing key), operator[], insert,
+ *	emplace, try_emplace, erase, reserve, iterators over
+ *	std::pair<const Key, Value>. Unlike std::unordered_map, entries
+ *	move when the table grows, so pointers, references and iterators to
+ *	them are invalidated by any insertion that grows it. Iteration order is
+ *	unspecified.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+	typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+	public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<const Key, Value>;
+	using size_type = std::size_t;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+
+	private:
+	using Control = std::int8_t;
+
+	static constexpr Control EMPTY = -128;
+	static constexpr Control DELETED = -2;
+	static constexpr Control SENTINEL = -1;
+	static constexpr std::size_t GROUP = 16;
+
+	union Slot
+	{
+		value_type value;
+
+		Slot() {}
+		~Slot() {}
+	};
+
+	/**
+	 * 16 control bytes, and bit masks of those matching a test
+	 */
+	struct Group
+	{
+#if defined(__SSE2__)
+		__m128i bytes;
+
+		explicit Group(const Control* control) :
+			bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) {}
+
+		unsigned match(Control hash) const
+		{
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), bytes));
+		}
+
+		// EMPTY and DELETED are the only bytes below SENTINEL
+		unsigned match_free() const
+		{
+			return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), bytes));
+		}
+#else
+		Control bytes[GROUP];
+
+		explicit Group(const Control* control)
+		{
+			std::memcpy(bytes, control, GROUP);
+		}
+
+		unsigned match(Control hash) const
+		{
+			unsigned mask = 0;
+			for (std::size_t i = 0; i < GROUP; i++)
+			{
+				mask |= static_cast<unsigned>(bytes[i] == hash) << i;
+			}
+			return mask;
+		}
+
+		unsigned match_free() const
+		{
+			unsigned mask = 0;
+			for (std::size_t i = 0; i < GROUP; i++)
+			{
+				mask |= static_cast<unsigned>(bytes[i] < SENTINEL) << i;
+			}
+			return mask;
+		}
+#endif
+
+		unsigned match_empty() const
+		{
+			return match(EMPTY);
+		}
+	};
+
+	template <typename Entry>
+	class Iterator
+	{
+		friend class FlatHashMap;
+
+		const Control* control;
+		Slot* slot;
+
+		Iterator(const Control* control, Slot* slot) : control(control), slot(slot)
+		{
+			skip_free();
+		}
+
+		// Every table ends with SENTINEL, which stops the walk
+		void skip_free()
+		{
+			if (control)
+			{
+				while (*control < SENTINEL)
+				{
+					control++;
+					slot++;
+				}
+				if (*control == SENTINEL)
+				{
+					control = nullptr;
+					slot = nullptr;
+				}
+			}
+		}
+
+		public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<const Key, Value>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Entry*;
+		using reference = Entry&;
+
+		Iterator() : control(nullptr), slot(nullptr) {}
+
+		// An iterator converts to a const_iterator
+		template <typename Other, typename = std::enable_if_t<
+			std::is_convertible<Other*, Entry*>::value>>
+		Iterator(const Iterator<Other>& other) :
+			control(other.control), slot(other.slot) {}
+
+		Entry& operator*() const
+		{
+			return slot->value;
+		}
+
+		Entry* operator->() const
+		{
+			return &slot->value;
+		}
+
+		Iterator& operator++()
+		{
+			control++;
+			slot++;
+			skip_free();
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator old = *this;
+			++*this;
+			return old;
+		}
+
+		bool operator==(const Iterator& other) const
+		{
+			return slot == other.slot;
+		}
+
+		bool operator!=(const Iterator& other) const
+		{
+			return slot != other.slot;
+		}
+
+		template <typename>
+		friend class Iterator;
+	};
+
+	Control* control;
+	Slot* slots;
+	std::size_t capacity;
+	std::size_t entries;
+	// Insertions into EMPTY slots left before the table must be rebuilt
+	std::size_t growth_left;
+	Hash hash_function;
+	KeyEqual equal;
+
+	/**
+	 * The hash mixed so that its low 7 bits and the rest both depend on
+	 * every bit: std::hash of an integer is often the integer itself
+	 */
+	std::size_t hash_of(const Key& key) const
+	{
+		std::uint64_t hash = static_cast<std::uint64_t>(hash_function(key));
+		hash *= 0x9E3779B97F4A7C15ull;
+		return static_cast<std::size_t>(hash ^ (hash >> 32));
+	}
+
+	static Control low_bits(std::size_t hash)
+	{
+		return static_cast<Control>(hash & 0x7F);
+	}
+
+	static std::size_t max_load(std::size_t capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	void set_control(std::size_t index, Control value)
+	{
+		control[index] = value;
+		control[((index - (GROUP - 1)) & capacity) + (GROUP - 1)] = value;
+	}
+
+	/**
+	 * Index of the slot holding key, or capacity when there is none
+	 */
+	std::size_t find_index(const Key& key, std::size_t hash) const
+	{
+		if (capacity == 0)
+		{
+			return capacity;
+		}
+		Control bits = low_bits(hash);
+		std::size_t position = (hash >> 7) & capacity;
+		for (std::size_t step = 0; ; )
+		{
+			Group group(control + position);
+			for (unsigned mask = group.match(bits); mask; mask &= mask - 1)
+			{
+				std::size_t index = (position + __builtin_ctz(mask)) & capacity;
+				if (equal(slots[index].value.first, key))
+				{
+					return index;
+				}
+			}
+			if (group.match_empty())
+			{
+				return capacity;
+			}
+			step += GROUP;
+			position = (position + step) & capacity;
+		}
+	}
+
+	/**
+	 * First EMPTY or DELETED slot on the probe sequence of hash
+	 */
+	std::size_t find_free(std::size_t hash) const
+	{
+		std::size_t position = (hash >> 7) & capacity;
+		for (std::size_t step = 0; ; )
+		{
+			unsigned mask = Group(control + position).match_free();
+			if (mask)
+			{
+				return (position + __builtin_ctz(mask)) & capacity;
+			}
+			step += GROUP;
+			position = (position + step) & capacity;
+		}
+	}
+
+	void allocate(std::size_t new_capacity)
+	{
+		capacity = new_capacity;
+		slots = new Slot[capacity];
+		control = new Control[capacity + GROUP];
+		std::memset(control, EMPTY, capacity + GROUP);
+		control[capacity] = SENTINEL;
+		growth_left = max_load(capacity);
+	}
+
+	/**
+	 * Moves every entry into a table of new_capacity slots, which also
+	 * clears out the DELETED markers
+	 */
+	void rebuild(std::size_t new_capacity)
+	{
+		Control* old_control = control;
+		Slot* old_slots = slots;
+		std::size_t old_capacity = capacity;
+
+		allocate(new_capacity);
+		for (std::size_t i = 0; i < old_capacity; i++)
+		{
+			if (old_control[i] >= 0)
+			{
+				value_type& entry = old_slots[i].value;
+				std::size_t hash = hash_of(entry.first);
+				std::size_t index = find_free(hash);
+				set_control(index, low_bits(hash));
+				::new (static_cast<void*>(&slots[index].value))
+					value_type(std::move(entry));
+				entry.~value_type();
+			}
+		}
+		growth_left -= entries;
+
+		delete[] old_slots;
+		delete[] old_control;
+	}
+
+	/**
+	 * Makes room for one more entry: grows the table, or only rebuilds it
+	 * in place when DELETED markers rather than entries fill it
+	 */
+	void prepare_insert()
+	{
+		if (capacity == 0)
+		{
+			allocate(GROUP - 1);
+		}
+		else if (growth_left == 0)
+		{
+			rebuild(entries * 2 < max_load(capacity) ? capacity : capacity * 2 + 1);
+		}
+	}
+
+	/**
+	 * Constructs an entry for key from args, unless key is already there.
+	 * Returns the slot and whether it was inserted.
+	 */
+	template <typename K, typename... Args>
+	std::pair<std::size_t, bool> insert_unique(const K& key, Args&&... args)
+	{
+		std::size_t hash = hash_of(key);
+		std::size_t index = find_index(key, hash);
+		if (index != capacity)
+		{
+			return {index, false};
+		}
+		prepare_insert();
+		index = find_free(hash);
+		if (control[index] == EMPTY)
+		{
+			growth_left--;
+		}
+		::new (static_cast<void*>(&slots[index].value))
+			value_type(std::forward<Args>(args)...);
+		set_control(index, low_bits(hash));
+		entries++;
+		return {index, true};
+	}
+
+	void destroy_all()
+	{
+		for (std::size_t i = 0; i < capacity; i++)
+		{
+			if (control[i] >= 0)
+			{
+				slots[i].value.~value_type();
+			}
+		}
+	}
+
+	void release()
+	{
+		if (capacity != 0)
+		{
+			destroy_all();
+			delete[] slots;
+			delete[] control;
+		}
+		control = nullptr;
+		slots = nullptr;
+		capacity = entries = growth_left = 0;
+	}
+
+	public:
+	using iterator = Iterator<value_type>;
+	using const_iterator = Iterator<const value_type>;
+
+	FlatHashMap() :
+		control(nullptr), slots(nullptr), capacity(0), entries(0), growth_left(0) {}
+
+	FlatHashMap(std::initializer_list<value_type> items) : FlatHashMap()
+	{
+		reserve(items.size());
+		for (const value_type& item : items)
+		{
+			insert(item);
+		}
+	}
+
+	FlatHashMap(const FlatHashMap& other) :
+		control(nullptr), slots(nullptr), capacity(0), entries(0), growth_left(0),
+		hash_function(other.hash_function), equal(other.equal)
+	{
+		reserve(other.entries);
+		for (const value_type& item : other)
+		{
+			insert(item);
+		}
+	}
+
+	// Moves only hand over the table, so they cannot throw unless moving
+	// the hasher or the key comparer can; std::vector then moves maps
+	// instead of copying them when it grows
+	FlatHashMap(FlatHashMap&& other) noexcept(
+			std::is_nothrow_move_constructible<Hash>::value
+			&& std::is_nothrow_move_constructible<KeyEqual>::value) :
+		control(other.control), slots(other.slots), capacity(other.capacity),
+		entries(other.entries), growth_left(other.growth_left),
+		hash_function(std::move(other.hash_function)),
+		equal(std::move(other.equal))
+	{
+		other.control = nullptr;
+		other.slots = nullptr;
+		other.capacity = other.entries = other.growth_left = 0;
+	}
+
+	FlatHashMap& operator=(const FlatHashMap& other)
+	{
+		if (this != &other)
+		{
+			FlatHashMap copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	FlatHashMap& operator=(FlatHashMap&& other) noexcept(
+			std::is_nothrow_move_assignable<Hash>::value
+			&& std::is_nothrow_move_assignable<KeyEqual>::value)
+	{
+		if (this != &other)
+		{
+			release();
+			control = other.control;
+			slots = other.slots;
+			capacity = other.capacity;
+			entries = other.entries;
+			growth_left = other.growth_left;
+			hash_function = std::move(other.hash_function);
+			equal = std::move(other.equal);
+			other.control = nullptr;
+			other.slots = nullptr;
+			other.capacity = other.entries = other.growth_left = 0;
+		}
+		return *this;
+	}
+
+	void swap(FlatHashMap& other) noexcept(
+			std::is_nothrow_swappable<Hash>::value
+			&& std::is_nothrow_swappable<KeyEqual>::value)
+	{
+		std::swap(control, other.control);
+		std::swap(slots, other.slots);
+		std::swap(capacity, other.capacity);
+		std::swap(entries, other.entries);
+		std::swap(growth_left, other.growth_left);
+		std::swap(hash_function, other.hash_function);
+		std::swap(equal, other.equal);
+	}
+
+	~FlatHashMap()
+	{
+		release();
+	}
+
+	iterator begin()
+	{
+		return iterator(control, slots);
+	}
+
+	iterator end()
+	{
+		return iterator();
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(control, slots);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator();
+	}
+
+	std::size_t size() const
+	{
+		return entries;
+	}
+
+	bool empty() const
+	{
+		return entries == 0;
+	}
+
+	/**
+	 * Slots in the table; it grows once more than 7 in 8 of them would be
+	 * in use
+	 */
+	std::size_t bucket_count() const
+	{
+		return capacity;
+	}
+
+	void clear()
+	{
+		if (capacity != 0)
+		{
+			destroy_all();
+			std::memset(control, EMPTY, capacity + GROUP);
+			control[capacity] = SENTINEL;
+			entries = 0;
+			growth_left = max_load(capacity);
+		}
+	}
+
+	/**
+	 * Room for size entries without growing
+	 */
+	void reserve(std::size_t size)
+	{
+		std::size_t wanted = GROUP - 1;
+		while (max_load(wanted) < size)
+		{
+			wanted = wanted * 2 + 1;
+		}
+		if (wanted > capacity)
+		{
+			if (capacity == 0)
+			{
+				allocate(wanted);
+			}
+			else
+			{
+				rebuild(wanted);
+			}
+		}
+	}
+
+	iterator find(const Key& key)
+	{
+		std::size_t index = find_index(key, hash_of(key));
+		return index != capacity
+			? iterator(control + index, slots + index) : end();
+	}
+
+	const_iterator find(const Key& key) const
+	{
+		std::size_t index = find_index(key, hash_of(key));
+		return index != capacity
+			? const_iterator(control + index, slots + index) : end();
+	}
+
+	std::size_t count(const Key& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	bool contains(const Key& key) const
+	{
+		return find_index(key, hash_of(key)) != capacity;
+	}
+
+	Value& at(const Key& key)
+	{
+		iterator found = find(key);
+		if (found == end())
+		{
+			throw std::out_of_range("FlatHashMap::at: key not found");
+		}
+		return found->second;
+	}
+
+	const Value& at(const Key& key) const
+	{
+		const_iterator found = find(key);
+		if (found == end())
+		{
+			throw std::out_of_range("FlatHashMap::at: key not found");
+		}
+		return found->second;
+	}
+
+	Value& operator[](const Key& key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	Value& operator[](Key&& key)
+	{
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+	{
+		auto [index, inserted] = insert_unique(key, std::piecewise_construct,
+				std::forward_as_tuple(key),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+		return {iterator(control + index, slots + index), inserted};
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+	{
+		auto [index, inserted] = insert_unique(key, std::piecewise_construct,
+				std::forward_as_tuple(std::move(key)),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+		return {iterator(control + index, slots + index), inserted};
+	}
+
+	std::pair<iterator, bool> insert(const value_type& item)
+	{
+		auto [index, inserted] = insert_unique(item.first, item);
+		return {iterator(control + index, slots + index), inserted};
+	}
+
+	std::pair<iterator, bool> insert(value_type&& item)
+	{
+		auto [index, inserted] = insert_unique(item.first, std::move(item));
+		return {iterator(control + index, slots + index), inserted};
+	}
+
+	/**
+	 * Builds the entry first to learn its key, as std::unordered_map does
+	 */
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		value_type item(std::forward<Args>(args)...);
+		return insert(std::move(item));
+	}
+
+	/**
+	 * Erases the entry at position and returns the one after it
+	 */
+	iterator erase(const_iterator position)
+	{
+		std::size_t index = position.slot - slots;
+		position.slot->value.~value_type();
+		entries--;
+
+		// A slot whose neighbourhood still has EMPTY bytes on both sides
+		// never filled a whole group, so no probe went past it: it can
+		// become EMPTY again instead of DELETED
+		std::size_t before = (index - GROUP) & capacity;
+		unsigned empty_after = Group(control + index).match_empty();
+		unsigned empty_before = Group(control + before).match_empty();
+		bool was_never_full = empty_after && empty_before
+			&& (__builtin_ctz(empty_after) + __builtin_clz(empty_before)
+					- (8 * sizeof(unsigned) - GROUP)) < GROUP;
+		set_control(index, was_never_full ? EMPTY : DELETED);
+		if (was_never_full)
+		{
+			growth_left++;
+		}
+		return iterator(control + index + 1, slots + index + 1);
+	}
+
+	std::size_t erase(const Key& key)
+	{
+		const_iterator found = find(key);
+		if (found == end())
+		{
+			return 0;
+		}
+		erase(found);
+		return 1;
+	}
+};
+
+#endif
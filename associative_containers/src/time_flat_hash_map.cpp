@@ -0,0 +1,106 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+#include "flat_hash_map.h"
+#include "timing.h"
+
+/**
+ * The same workloads on any map from unsigned to unsigned long long:
+ * filling a memo table, looking up keys that are there and keys that are
+ * not, counting calls per key, and erasing half the keys
+ */
+template <typename Map>
+void run(const std::string& name, const std::vector<unsigned>& keys,
+		const std::vector<unsigned>& missing, const std::vector<unsigned>& calls)
+{
+	Map map;
+	unsigned long long check = 0;
+
+	double insert_time = time_msec([&] ()
+		{
+			for (unsigned key : keys)
+			{
+				map[key] = key;
+			}
+		});
+	double hit_time = time_msec([&] ()
+		{
+			for (unsigned key : keys)
+			{
+				check += map.find(key)->second;
+			}
+		});
+	double miss_time = time_msec([&] ()
+		{
+			for (unsigned key : missing)
+			{
+				check += map.count(key);
+			}
+		});
+
+	Map counter;
+	double count_time = time_msec([&] ()
+		{
+			for (unsigned key : calls)
+			{
+				counter[key]++;
+			}
+		});
+	check += counter.size();
+
+	double erase_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < keys.size(); i += 2)
+			{
+				check += map.erase(keys[i]);
+			}
+		});
+
+	std::cout << std::left << std::setw(16) << name << std::right << std::fixed
+		<< std::setprecision(1) << std::setw(10) << insert_time
+		<< std::setw(10) << hit_time << std::setw(10) << miss_time
+		<< std::setw(10) << count_time << std::setw(10) << erase_time
+		<< "    (check " << check << ")\n";
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 1000000;
+
+	// Distinct random keys, and keys known to be absent: even keys are
+	// stored, odd keys are looked up and missed
+	std::mt19937 generator(42);
+	std::vector<unsigned> keys(size), missing(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		unsigned key = generator() & ~1u;
+		keys[i] = key;
+		missing[i] = key | 1u;
+	}
+	std::shuffle(keys.begin(), keys.end(), generator);
+
+	// Calls counted per argument as in fibonacci_instrumented.cpp: few
+	// distinct arguments, some called far more often than others
+	std::geometric_distribution<unsigned> argument(0.001);
+	std::vector<unsigned> calls(4 * size);
+	for (unsigned& call : calls)
+	{
+		call = argument(generator);
+	}
+
+	std::cout << size << " keys, msec      insert       hit      miss"
+		"     count     erase\n";
+	run<FlatHashMap<unsigned, unsigned long long>>("FlatHashMap", keys, missing,
+			calls);
+	run<std::unordered_map<unsigned, unsigned long long>>("unordered_map", keys,
+			missing, calls);
+	run<std::map<unsigned, unsigned long long>>("map", keys, missing, calls);
+}
@@ -5,8 +5,8 @@ template <typename Type>
 class Comparer
 {
 	// Keep track of comparisons
-	int compare_count;
-	int swap_count;
+	long long compare_count;
+	long long swap_count;
 	bool (*comparison_function) (const Type&, const Type&);
 
 	protected:
@@ -44,12 +44,12 @@ class Comparer
 		return swap_implementation(value_one, value_two);
 	}
 
-	int comparisons() const
+	long long comparisons() const
 	{
 		return compare_count;
 	}
 
-	int swaps() const 
+	long long swaps() const 
 	{
 		return swap_count;
 	}
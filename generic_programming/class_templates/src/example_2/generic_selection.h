@@ -0,0 +1,236 @@
+#ifndef GENERIC_SELECTION_H_
+#define GENERIC_SELECTION_H_
+
+#include <vector>
+
+#include "generic_comparer.h"
+
+/**
+ * NOTE:
+ *	These algorithms only need the k values that come first under the
+ *	comparer, so they avoid the cost of a full sort. Every comparison and
+ *	swap goes through the Comparer, so its counters stay exact.
+ *
+ *	The helpers below keep a heap whose root is the value that would come
+ *	LAST among the ones kept. A new value only has to beat the root.
+ */
+template <typename Type>
+void selection_sift_down(std::vector<Type>& values, int root, int size,
+		Comparer<Type>& comparer)
+{
+	while (true)
+	{
+		int child = 2 * root + 1;
+		if (child >= size)
+		{
+			return;
+		}
+
+		// Pick the child that comes later in the ordering
+		if (child + 1 < size
+				&& comparer.compare(values[child], values[child + 1]))
+		{
+			child++;
+		}
+
+		if (!comparer.compare(values[root], values[child]))
+		{
+			return;
+		}
+		comparer.swap(values[root], values[child]);
+		root = child;
+	}
+}
+
+
+template <typename Type>
+void selection_sift_up(std::vector<Type>& values, int child,
+		Comparer<Type>& comparer)
+{
+	while (child > 0)
+	{
+		int parent = (child - 1) / 2;
+		if (!comparer.compare(values[parent], values[child]))
+		{
+			return;
+		}
+		comparer.swap(values[parent], values[child]);
+		child = parent;
+	}
+}
+
+
+/**
+ * Rearranges values so that its first k elements are the k values that come
+ * first under the comparer, in order. The order of the remaining elements is
+ * unspecified. Runs in O(n log k).
+ */
+template <typename Type>
+void partial_sort(std::vector<Type>& values, int k, Comparer<Type>& comparer)
+{
+	int size = values.size();
+	if (k > size)
+	{
+		k = size;
+	}
+	if (k <= 0)
+	{
+		return;
+	}
+
+	// Build a heap out of the first k values
+	for (int i = k / 2 - 1; i >= 0; i--)
+	{
+		selection_sift_down(values, i, k, comparer);
+	}
+
+	// Every remaining value that beats the root replaces it
+	for (int i = k; i < size; i++)
+	{
+		if (comparer.compare(values[i], values[0]))
+		{
+			comparer.swap(values[i], values[0]);
+			selection_sift_down(values, 0, k, comparer);
+		}
+	}
+
+	// Heap sort the winners: the root always belongs at the back
+	for (int last = k - 1; last > 0; last--)
+	{
+		comparer.swap(values[0], values[last]);
+		selection_sift_down(values, 0, last, comparer);
+	}
+}
+
+
+/**
+ * Rearranges values so that values[n] holds the value a full sort would put
+ * there, everything before it does not come after it and everything after
+ * it does not come before it. Runs in O(n) on average.
+ */
+template <typename Type>
+void nth_element(std::vector<Type>& values, int n, Comparer<Type>& comparer)
+{
+	int low = 0, high = values.size() - 1;
+	if (n < 0 || n > high)
+	{
+		return;
+	}
+
+	while (low < high)
+	{
+		// Use the median of the first, middle and last values as the pivot
+		int middle = low + (high - low) / 2;
+		if (comparer.compare(values[middle], values[low]))
+		{
+			comparer.swap(values[middle], values[low]);
+		}
+		if (comparer.compare(values[high], values[low]))
+		{
+			comparer.swap(values[high], values[low]);
+		}
+		if (comparer.compare(values[middle], values[high]))
+		{
+			comparer.swap(values[middle], values[high]);
+		}
+
+		// Three way partition so that runs of equal values cannot make the
+		// search quadratic: [low, less) < pivot, [less, greater) == pivot,
+		// [greater, high] > pivot
+		Type pivot = values[high];
+		int less = low, cursor = low, greater = high + 1;
+		while (cursor < greater)
+		{
+			if (comparer.compare(values[cursor], pivot))
+			{
+				if (cursor != less)
+				{
+					comparer.swap(values[cursor], values[less]);
+				}
+				less++;
+				cursor++;
+			}
+			else if (comparer.compare(pivot, values[cursor]))
+			{
+				greater--;
+				if (cursor != greater)
+				{
+					comparer.swap(values[cursor], values[greater]);
+				}
+			}
+			else
+			{
+				cursor++;
+			}
+		}
+
+		// Only keep looking in the part that holds position n
+		if (n < less)
+		{
+			high = less - 1;
+		}
+		else if (n >= greater)
+		{
+			low = greater;
+		}
+		else
+		{
+			return;
+		}
+	}
+}
+
+
+/**
+ * Keeps the k values that come first under the comparer out of a stream of
+ * any length. Only k values are ever held, and a value that cannot make the
+ * cut costs a single comparison against the heap root.
+ */
+template <typename Type>
+class TopK
+{
+	int capacity;
+	std::vector<Type> heap;
+	Comparer<Type>& comparer;
+
+	public:
+	TopK(int k, Comparer<Type>& comparer) : capacity(k), comparer(comparer)
+	{
+		heap.reserve(k > 0 ? k : 0);
+	}
+
+	void push(const Type& value)
+	{
+		if (static_cast<int>(heap.size()) < capacity)
+		{
+			heap.push_back(value);
+			selection_sift_up(heap, heap.size() - 1, comparer);
+		}
+		else if (capacity > 0 && comparer.compare(value, heap[0]))
+		{
+			heap[0] = value;
+			selection_sift_down(heap, 0, heap.size(), comparer);
+		}
+	}
+
+	int size() const
+	{
+		return heap.size();
+	}
+
+	/**
+	 * Returns the values kept so far, in order
+	 */
+	std::vector<Type> results() const
+	{
+		std::vector<Type> sorted = heap;
+		for (int last = sorted.size() - 1; last > 0; last--)
+		{
+			comparer.swap(sorted[0], sorted[last]);
+			selection_sift_down(sorted, 0, last, comparer);
+		}
+		return sorted;
+	}
+};
+
+#endif
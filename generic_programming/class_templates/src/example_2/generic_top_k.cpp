@@ -0,0 +1,93 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <random>
+#include <ctime>
+#include <cstdlib>
+
+#include "generic_comparer.h"
+#include "generic_selection.h"
+
+template<typename Type>
+std::ostream& operator<<(std::ostream& os, const std::vector<Type>& values)
+{
+	int size = values.size();
+	os << "{ ";
+	if (size > 0)
+	{
+		os << values[0];
+		for (int i = 1; i < size; i++)
+		{
+			os << ", " << values[i];
+		}
+	}
+	os << " }";
+	return os;
+}
+
+
+template <typename Type>
+bool greater_than(const Type& value_one, const Type& value_two)
+{
+	return value_one > value_two;
+}
+
+
+template <typename Type>
+bool less_than(const Type& value_one, const Type& value_two)
+{
+	return value_one < value_two;
+}
+
+
+template <typename Type>
+void print_counts(const Comparer<Type>& comparer)
+{
+	std::cout << "( " << comparer.comparisons() << " comparisons, "
+		<< comparer.swaps() << " swaps)" << std::endl;
+	std::cout << "-------------------------------------------------" << std::endl;
+}
+
+
+int main(int argc, char* argv[])
+{
+	Comparer<int> less_than_comparer(less_than<int>);
+	Comparer<int> greater_than_comparer(greater_than<int>);
+	std::vector<int> original {23, -3, 4, 215, 0, -3, 2, 23, 100, 88, -10};
+
+	/* Smallest three values, in order */
+	std::vector<int> working = original;
+	partial_sort(working, 3, less_than_comparer);
+	std::cout << "Smallest 3: ";
+	std::cout << std::vector<int>(working.begin(), working.begin() + 3)
+		<< std::endl;
+	print_counts(less_than_comparer);
+
+	/* The median, without sorting the rest */
+	working = original;
+	less_than_comparer.reset();
+	nth_element(working, working.size() / 2, less_than_comparer);
+	std::cout << "Median: " << working[working.size() / 2] << std::endl;
+	print_counts(less_than_comparer);
+
+	/* Largest values of a stream that is never stored */
+	long long count = argc > 1 ? std::atoll(argv[1]) : 10000000;
+	std::mt19937 generator(2024);
+	TopK<int> largest(100, greater_than_comparer);
+
+	clock_t start_time = clock();
+	for (long long i = 0; i < count; i++)
+	{
+		largest.push(static_cast<int>(generator() >> 1));
+	}
+	clock_t end_time = clock();
+
+	std::vector<int> top = largest.results();
+	std::cout << "Largest 5 of " << count << " streamed values: "
+		<< std::vector<int>(top.begin(),
+				top.begin() + std::min<std::size_t>(5, top.size())) << std::endl;
+	std::cout << "Time: " << (end_time - start_time) * 1000 / CLOCKS_PER_SEC
+		<< " msec" << std::endl;
+	print_counts(greater_than_comparer);
+}
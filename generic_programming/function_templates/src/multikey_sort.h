@@ -0,0 +1,233 @@
+#ifndef MULTIKEY_SORT_H_
+#define MULTIKEY_SORT_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <cstring>
+
+/**
+ * NOTE:
+ *	Sorting strings through less_than<std::string> makes every comparison
+ *	chase two heap pointers and rescan the prefix both strings share.
+ *	Multikey quicksort partitions on one "digit" at a time and never looks
+ *	at a character again once the strings agree on it. Here a digit is an
+ *	8 byte chunk cached inline next to the string pointer, so partitioning
+ *	only touches the dense array of entries.
+ */
+struct MultikeyEntry
+{
+	// The next 8 bytes of the string, packed big endian so that integer
+	// order matches lexicographic order. Missing bytes are zero.
+	std::uint64_t prefix;
+
+	// How many of those 8 bytes really belong to the string; 8 means the
+	// string may continue past this chunk
+	std::uint32_t tail;
+
+	std::string* string;
+};
+
+
+/**
+ * Reloads the cached chunk of entry starting at character depth
+ */
+inline void multikey_load(MultikeyEntry& entry, std::size_t depth)
+{
+	const std::string& text = *entry.string;
+	std::size_t remaining = text.size() > depth ? text.size() - depth : 0;
+	std::size_t count = remaining < 8 ? remaining : 8;
+
+	std::uint64_t prefix = 0;
+	if (count == 8)
+	{
+		unsigned char bytes[8];
+		std::memcpy(bytes, text.data() + depth, 8);
+		for (int index = 0; index < 8; index++)
+		{
+			prefix = (prefix << 8) | bytes[index];
+		}
+	}
+	else
+	{
+		for (std::size_t index = 0; index < count; index++)
+		{
+			prefix |= static_cast<std::uint64_t>(
+					static_cast<unsigned char>(text[depth + index]))
+				<< (56 - 8 * index);
+		}
+	}
+	entry.prefix = prefix;
+	entry.tail = static_cast<std::uint32_t>(count);
+}
+
+
+/**
+ * Orders two entries on their cached chunk. When the chunks are equal the
+ * shorter string is a prefix of the longer one, so it goes first.
+ */
+inline bool multikey_less(const MultikeyEntry& one, const MultikeyEntry& two)
+{
+	return one.prefix < two.prefix
+		|| (one.prefix == two.prefix && one.tail < two.tail);
+}
+
+
+inline bool multikey_equal(const MultikeyEntry& one, const MultikeyEntry& two)
+{
+	return one.prefix == two.prefix && one.tail == two.tail;
+}
+
+
+/**
+ * Compares the characters of two strings from depth onwards; the caller has
+ * already established that everything before depth matches
+ */
+inline bool multikey_suffix_less(const std::string& one,
+		const std::string& two, std::size_t depth)
+{
+	return one.compare(depth, std::string::npos,
+			two, depth, std::string::npos) < 0;
+}
+
+
+/**
+ * Sorts small ranges by insertion. Entries whose chunks tie and are both
+ * full fall back to comparing the rest of the strings.
+ */
+inline void multikey_insertion_sort(MultikeyEntry* begin, MultikeyEntry* end,
+		std::size_t depth)
+{
+	for (MultikeyEntry* cursor = begin + 1; cursor < end; cursor++)
+	{
+		MultikeyEntry value = *cursor;
+		MultikeyEntry* hole = cursor;
+		while (hole > begin)
+		{
+			const MultikeyEntry& previous = *(hole - 1);
+			bool smaller = multikey_less(value, previous)
+				|| (multikey_equal(value, previous) && value.tail == 8
+					&& multikey_suffix_less(*value.string,
+						*previous.string, depth + 8));
+			if (!smaller)
+			{
+				break;
+			}
+			*hole = previous;
+			hole--;
+		}
+		*hole = value;
+	}
+}
+
+
+/**
+ * Picks the median of the first, middle and last entries as the pivot
+ */
+inline MultikeyEntry multikey_pivot(const MultikeyEntry* begin,
+		const MultikeyEntry* end)
+{
+	const MultikeyEntry& first = *begin;
+	const MultikeyEntry& middle = begin[(end - begin) / 2];
+	const MultikeyEntry& last = *(end - 1);
+
+	if (multikey_less(first, middle))
+	{
+		if (multikey_less(middle, last))
+		{
+			return middle;
+		}
+		return multikey_less(first, last) ? last : first;
+	}
+	if (multikey_less(first, last))
+	{
+		return first;
+	}
+	return multikey_less(middle, last) ? last : middle;
+}
+
+
+/**
+ * Sorts the entries in [begin, end), all of which agree on their first
+ * depth characters and have their chunk at depth cached
+ */
+inline void multikey_quicksort(MultikeyEntry* begin, MultikeyEntry* end,
+		std::size_t depth)
+{
+	const std::ptrdiff_t INSERTION_THRESHOLD = 16;
+
+	while (end - begin > INSERTION_THRESHOLD)
+	{
+		MultikeyEntry pivot = multikey_pivot(begin, end);
+
+		// Three way partition: [begin, less) < pivot, [less, cursor) == pivot,
+		// [greater, end) > pivot
+		MultikeyEntry* less = begin;
+		MultikeyEntry* cursor = begin;
+		MultikeyEntry* greater = end;
+		while (cursor < greater)
+		{
+			if (multikey_less(*cursor, pivot))
+			{
+				std::swap(*less++, *cursor++);
+			}
+			else if (multikey_less(pivot, *cursor))
+			{
+				std::swap(*cursor, *--greater);
+			}
+			else
+			{
+				cursor++;
+			}
+		}
+
+		multikey_quicksort(begin, less, depth);
+		multikey_quicksort(greater, end, depth);
+
+		// Strings that ended inside the pivot chunk are identical
+		if (pivot.tail < 8)
+		{
+			return;
+		}
+
+		// The rest agree on 8 more characters, so move on to the next chunk
+		depth += 8;
+		for (MultikeyEntry* entry = less; entry < greater; entry++)
+		{
+			multikey_load(*entry, depth);
+		}
+		begin = less;
+		end = greater;
+	}
+
+	multikey_insertion_sort(begin, end, depth);
+}
+
+
+/**
+ * Sorts a vector of strings into ascending lexicographic order
+ */
+inline void multikey_sort(std::vector<std::string>& values)
+{
+	std::vector<MultikeyEntry> entries(values.size());
+	for (std::size_t index = 0; index < values.size(); index++)
+	{
+		entries[index].string = &values[index];
+		multikey_load(entries[index], 0);
+	}
+
+	multikey_quicksort(entries.data(), entries.data() + entries.size(), 0);
+
+	// Move the strings into their final positions in one pass
+	std::vector<std::string> sorted;
+	sorted.reserve(values.size());
+	for (const auto& entry : entries)
+	{
+		sorted.push_back(std::move(*entry.string));
+	}
+	values = std::move(sorted);
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "multikey_sort.h"
+
+template <typename T>
+bool less_than(const T& a, const T& b)
+{
+	return a < b;
+}
+
+template <typename T>
+void print(const std::vector<T>& vec)
+{
+	int n = vec.size();
+	std::cout << "{ ";
+	if (n > 0)
+	{
+		std::cout << vec[0];
+		for (int i = 1; i < n; i++)
+		{
+			std::cout << ", " << vec[i];
+		}
+	}
+	std::cout << " }";
+}
+
+/**
+ * Builds count URL-like strings that share long common prefixes, which is
+ * the worst case for comparison sorts on std::string
+ */
+std::vector<std::string> make_urls(int count)
+{
+	const std::vector<std::string> hosts {
+		"https://www.example.com/catalogue/products/",
+		"https://www.example.com/catalogue/reviews/",
+		"https://static.example.org/assets/images/",
+		"https://api.example.net/v2/users/"};
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> pick_host(0, hosts.size() - 1);
+	std::uniform_int_distribution<int> pick_id(0, 999999);
+
+	std::vector<std::string> urls;
+	urls.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		urls.push_back(hosts[pick_host(generator)] + "item-"
+				+ std::to_string(pick_id(generator)) + "/index.html");
+	}
+	return urls;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> words {"tree", "girl", "boy", "apple", "dog",
+		"cat", "bird", "bi", "birds", ""};
+	std::cout << "Original: ";
+	print(words);
+	std::cout << std::endl;
+
+	multikey_sort(words);
+	std::cout << "Ascending: ";
+	print(words);
+	std::cout << std::endl;
+	std::cout << "----------------------------------------------------------"
+		<< std::endl;
+
+	// Time both sorts on a large batch of URLs
+	int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	std::vector<std::string> urls = make_urls(count);
+	std::vector<std::string> working = urls;
+
+	auto start = std::chrono::steady_clock::now();
+	std::sort(std::begin(working), std::end(working), less_than<std::string>);
+	auto stop = std::chrono::steady_clock::now();
+	auto comparison_time = std::chrono::duration_cast
+		<std::chrono::milliseconds>(stop - start).count();
+
+	// Sort a fresh copy so that both sorts start from the same memory layout
+	std::vector<std::string> expected = std::move(working);
+	working = std::vector<std::string>(urls);
+
+	start = std::chrono::steady_clock::now();
+	multikey_sort(working);
+	stop = std::chrono::steady_clock::now();
+	auto multikey_time = std::chrono::duration_cast
+		<std::chrono::milliseconds>(stop - start).count();
+
+	std::cout << "Sorting " << count << " URLs" << std::endl;
+	std::cout << "std::sort with less_than: " << comparison_time << " msec"
+		<< std::endl;
+	std::cout << "multikey_sort:            " << multikey_time << " msec"
+		<< std::endl;
+	std::cout << "Results match: " << std::boolalpha << (working == expected)
+		<< std::endl;
+	std::cout << "----------------------------------------------------------"
+		<< std::endl;
+}
@@ -0,0 +1,203 @@
+#ifndef CHUNKED_LIST_H_
+#define CHUNKED_LIST_H_
+
+#include <iterator>
+#include <cstddef>
+
+#include "segmented_iterator.h"
+
+/**
+ * A list of fixed size blocks: elements are stored BlockSize at a time in
+ * arrays, and the arrays are linked together. Appending never moves
+ * existing elements, and walking the list touches one new cache line per
+ * few elements instead of one per element as std::list does.
+ */
+template <typename Type, std::size_t BlockSize>
+struct ChunkedListBlock
+{
+	Type items[BlockSize];
+	std::size_t count = 0;
+	ChunkedListBlock* next = nullptr;
+};
+
+
+template <typename Type, std::size_t BlockSize>
+class ChunkedListIterator
+{
+	using Block = ChunkedListBlock<Type, BlockSize>;
+
+	Block* block;
+	std::size_t index;
+
+	public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = Type;
+	using difference_type = std::ptrdiff_t;
+	using pointer = Type*;
+	using reference = Type&;
+
+	ChunkedListIterator(Block* block = nullptr, std::size_t index = 0) :
+		block(block), index(index) {}
+
+	Type& operator*() const
+	{
+		return block->items[index];
+	}
+
+	Type* operator->() const
+	{
+		return &block->items[index];
+	}
+
+	ChunkedListIterator& operator++()
+	{
+		index++;
+		// The end of the last block is the end of the list, so only move
+		// on when there is a next block
+		if (index == block->count && block->next)
+		{
+			block = block->next;
+			index = 0;
+		}
+		return *this;
+	}
+
+	ChunkedListIterator operator++(int)
+	{
+		ChunkedListIterator old = *this;
+		++*this;
+		return old;
+	}
+
+	bool operator==(const ChunkedListIterator& other) const
+	{
+		return block == other.block && index == other.index;
+	}
+
+	bool operator!=(const ChunkedListIterator& other) const
+	{
+		return !(*this == other);
+	}
+
+	Block* get_block() const
+	{
+		return block;
+	}
+
+	std::size_t get_index() const
+	{
+		return index;
+	}
+};
+
+
+template <typename Type, std::size_t BlockSize = 1024>
+class ChunkedList
+{
+	using Block = ChunkedListBlock<Type, BlockSize>;
+
+	Block* head;
+	Block* tail;
+	std::size_t length;
+
+	public:
+	using iterator = ChunkedListIterator<Type, BlockSize>;
+
+	ChunkedList() : head(nullptr), tail(nullptr), length(0) {}
+
+	ChunkedList(const ChunkedList&) = delete;
+	ChunkedList& operator=(const ChunkedList&) = delete;
+
+	~ChunkedList()
+	{
+		clear();
+	}
+
+	void push_back(const Type& item)
+	{
+		if (!tail || tail->count == BlockSize)
+		{
+			Block* block = new Block;
+			if (tail)
+			{
+				tail->next = block;
+			}
+			else
+			{
+				head = block;
+			}
+			tail = block;
+		}
+		tail->items[tail->count++] = item;
+		length++;
+	}
+
+	std::size_t size() const
+	{
+		return length;
+	}
+
+	iterator begin() const
+	{
+		return iterator(head, 0);
+	}
+
+	iterator end() const
+	{
+		return tail ? iterator(tail, tail->count) : iterator();
+	}
+
+	void clear()
+	{
+		while (head)
+		{
+			Block* next = head->next;
+			delete head;
+			head = next;
+		}
+		tail = nullptr;
+		length = 0;
+	}
+};
+
+
+/**
+ * Each block of a ChunkedList is a segment, and a plain pointer walks the
+ * elements inside it
+ */
+template <typename Type, std::size_t BlockSize>
+struct segmented_iterator_traits<ChunkedListIterator<Type, BlockSize>>
+{
+	using Iterator = ChunkedListIterator<Type, BlockSize>;
+	using segment_iterator = ChunkedListBlock<Type, BlockSize>*;
+	using local_iterator = Type*;
+
+	static constexpr bool is_segmented = true;
+
+	static segment_iterator segment(const Iterator& iterator)
+	{
+		return iterator.get_block();
+	}
+
+	static local_iterator local(const Iterator& iterator)
+	{
+		return iterator.get_block()->items + iterator.get_index();
+	}
+
+	static local_iterator begin(segment_iterator segment)
+	{
+		return segment->items;
+	}
+
+	static local_iterator end(segment_iterator segment)
+	{
+		return segment->items + segment->count;
+	}
+
+	static segment_iterator next(segment_iterator segment)
+	{
+		return segment->next;
+	}
+};
+
+#endif
@@ -0,0 +1,282 @@
+#ifndef COUNT_VALUES_H_
+#define COUNT_VALUES_H_
+
+#include <vector>
+#include <thread>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#include "generic_count.h"
+
+/**
+ * NOTE:
+ *	Calling count_value once per value we are interested in scans the data
+ *	once per value. A ValueCounter scans it once and counts every seek key
+ *	as it goes:
+ *	- Up to SMALL_SET keys are compared directly. For 32 bit integers in
+ *	  contiguous memory built with AVX2, each key is broadcast into a
+ *	  vector and 8 elements are compared against it at a time.
+ *	- Larger key sets are looked up in an open addressing hash table, so
+ *	  each element costs one hash and usually one probe.
+ *	Counts are plain sums, so separate chunks of the data can be counted on
+ *	separate threads and added together (see count_values_parallel).
+ *
+ *	Key needs a hash function object (std::hash by default) and ==.
+ */
+template <typename Key, typename Hash = std::hash<Key>,
+		 typename Equal = std::equal_to<Key>>
+class ValueCounter
+{
+	static constexpr std::size_t SMALL_SET = 8;
+
+	std::vector<Key> keys;
+
+	// For every key, the index of the first key equal to it. Duplicate
+	// keys are only counted once and copied at the end.
+	std::vector<std::size_t> first_equal;
+
+	// Open addressing table of key indices; -1 marks an empty slot
+	std::vector<std::ptrdiff_t> table;
+	std::size_t mask;
+
+	Hash hash;
+	Equal equal;
+
+	/**
+	 * Returns the index of the key equal to value, or -1
+	 */
+	std::ptrdiff_t find(const Key& value) const
+	{
+		std::size_t slot = hash(value) & mask;
+		while (table[slot] >= 0)
+		{
+			if (equal(keys[table[slot]], value))
+			{
+				return table[slot];
+			}
+			slot = (slot + 1) & mask;
+		}
+		return -1;
+	}
+
+	template <typename Iterator>
+	void count_small(Iterator begin, Iterator end, std::ptrdiff_t* counts) const
+	{
+		std::size_t size = keys.size();
+		for (auto cursor = begin; cursor != end; ++cursor)
+		{
+			const auto& value = *cursor;
+			for (std::size_t k = 0; k < size; k++)
+			{
+				counts[k] += equal(keys[k], value);
+			}
+		}
+	}
+
+#ifdef __AVX2__
+	/**
+	 * Compares 8 integers at a time against each broadcast key; every match
+	 * is -1 in its lane, so subtracting the comparison counts it
+	 */
+	void count_small_simd(const Key* data, std::size_t size,
+			std::ptrdiff_t* counts) const
+	{
+		std::size_t key_count = keys.size();
+		__m256i needles[SMALL_SET];
+		__m256i totals[SMALL_SET];
+		for (std::size_t k = 0; k < key_count; k++)
+		{
+			needles[k] = _mm256_set1_epi32(static_cast<int>(keys[k]));
+			totals[k] = _mm256_setzero_si256();
+		}
+
+		// Lanes are 32 bits wide, so fold them into counts before any of
+		// them could overflow
+		const std::size_t FLUSH = std::size_t(1) << 30;
+		std::size_t i = 0;
+		while (i + 8 <= size)
+		{
+			std::size_t stop = i + FLUSH < size ? i + FLUSH : size;
+			for (; i + 8 <= stop; i += 8)
+			{
+				__m256i block = _mm256_loadu_si256(
+						reinterpret_cast<const __m256i*>(data + i));
+				for (std::size_t k = 0; k < key_count; k++)
+				{
+					totals[k] = _mm256_sub_epi32(totals[k],
+							_mm256_cmpeq_epi32(block, needles[k]));
+				}
+			}
+			for (std::size_t k = 0; k < key_count; k++)
+			{
+				alignas(32) std::uint32_t lanes[8];
+				_mm256_store_si256(reinterpret_cast<__m256i*>(lanes),
+						totals[k]);
+				for (int lane = 0; lane < 8; lane++)
+				{
+					counts[k] += lanes[lane];
+				}
+				totals[k] = _mm256_setzero_si256();
+			}
+		}
+		count_small(data + i, data + size, counts);
+	}
+#endif
+
+	template <typename Iterator>
+	void count_table(Iterator begin, Iterator end, std::ptrdiff_t* counts) const
+	{
+		for (auto cursor = begin; cursor != end; ++cursor)
+		{
+			std::ptrdiff_t index = find(*cursor);
+			if (index >= 0)
+			{
+				counts[index]++;
+			}
+		}
+	}
+
+	public:
+	ValueCounter(const std::vector<Key>& seeks, const Hash& hash = Hash(),
+			const Equal& equal = Equal()) :
+		keys(seeks), first_equal(seeks.size()), mask(0), hash(hash),
+		equal(equal)
+	{
+		// The table is at most half full so that probe sequences stay short
+		std::size_t capacity = 1;
+		while (capacity < 2 * keys.size())
+		{
+			capacity *= 2;
+		}
+		table.assign(capacity, -1);
+		mask = capacity - 1;
+
+		for (std::size_t k = 0; k < keys.size(); k++)
+		{
+			std::ptrdiff_t existing = find(keys[k]);
+			if (existing >= 0)
+			{
+				first_equal[k] = existing;
+				continue;
+			}
+			first_equal[k] = k;
+
+			std::size_t slot = hash(keys[k]) & mask;
+			while (table[slot] >= 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+			table[slot] = k;
+		}
+	}
+
+	std::size_t size() const
+	{
+		return keys.size();
+	}
+
+	/**
+	 * Adds the number of times each key occurs in [begin, end) to
+	 * counts[0 .. size())
+	 */
+	template <typename Iterator>
+	void count(Iterator begin, Iterator end, std::ptrdiff_t* counts) const
+	{
+		std::vector<std::ptrdiff_t> partial(keys.size(), 0);
+		if (keys.size() > SMALL_SET)
+		{
+			count_table(begin, end, partial.data());
+		}
+		else
+		{
+#ifdef __AVX2__
+			using Value = typename std::iterator_traits<Iterator>::value_type;
+			if constexpr (is_contiguous_iterator<Iterator>::value
+					&& std::is_integral<Key>::value && sizeof(Key) == 4
+					&& std::is_same<Key, Value>::value)
+			{
+				if (begin != end)
+				{
+					count_small_simd(&*begin, end - begin, partial.data());
+				}
+			}
+			else
+			{
+				count_small(begin, end, partial.data());
+			}
+#else
+			count_small(begin, end, partial.data());
+#endif
+		}
+
+		// Only the first of several equal keys was counted
+		for (std::size_t k = 0; k < keys.size(); k++)
+		{
+			counts[k] += partial[first_equal[k]];
+		}
+	}
+};
+
+
+/**
+ * Returns how many times each of seeks occurs in [begin, end), in one pass
+ */
+template <typename Iterator, typename Key, typename Hash = std::hash<Key>,
+		 typename Equal = std::equal_to<Key>>
+std::vector<std::ptrdiff_t> count_values(Iterator begin, Iterator end,
+		const std::vector<Key>& seeks, const Hash& hash = Hash(),
+		const Equal& equal = Equal())
+{
+	ValueCounter<Key, Hash, Equal> counter(seeks, hash, equal);
+	std::vector<std::ptrdiff_t> counts(seeks.size(), 0);
+	counter.count(begin, end, counts.data());
+	return counts;
+}
+
+
+/**
+ * Same as count_values, but splits a random access range into one chunk per
+ * thread and adds up the counts of the chunks
+ */
+template <typename Iterator, typename Key, typename Hash = std::hash<Key>,
+		 typename Equal = std::equal_to<Key>>
+std::vector<std::ptrdiff_t> count_values_parallel(Iterator begin,
+		Iterator end, const std::vector<Key>& seeks, unsigned threads,
+		const Hash& hash = Hash(), const Equal& equal = Equal())
+{
+	ValueCounter<Key, Hash, Equal> counter(seeks, hash, equal);
+	if (threads == 0)
+	{
+		threads = 1;
+	}
+
+	std::ptrdiff_t size = end - begin;
+	std::vector<std::vector<std::ptrdiff_t>> partial(threads,
+			std::vector<std::ptrdiff_t>(seeks.size(), 0));
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threads; t++)
+	{
+		Iterator first = begin + size * t / threads;
+		Iterator last = begin + size * (t + 1) / threads;
+		workers.emplace_back([&counter, &partial, first, last, t] ()
+			{
+				counter.count(first, last, partial[t].data());
+			});
+	}
+
+	std::vector<std::ptrdiff_t> counts(seeks.size(), 0);
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers[t].join();
+		for (std::size_t k = 0; k < seeks.size(); k++)
+		{
+			counts[k] += partial[t][k];
+		}
+	}
+	return counts;
+}
+
+#endif
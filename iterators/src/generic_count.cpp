@@ -4,28 +4,7 @@
 #include <list>
 #include <string>
 
-using Iterator = std::vector<int>::iterator;
-
-/**
- * Count the elements in a vactor of integers that match seek
- * Type Iterator is an iterator type working with a container that contains
- * elements of type Type. Type Type elements must be compatible with
- * operator==
- */
-	template <typename Iterator, typename Type>
-int count_value(Iterator iterator_begin, Iterator iterator_end, const Type& seek)
-{
-	int count = 0;
-	for (auto cursor = iterator_begin; cursor != iterator_end;
-			cursor++)
-	{
-		if (*cursor == seek)
-		{
-			count++;
-		}
-	}
-	return count;
-}
+#include "generic_count.h"
 
 
 int main()
@@ -0,0 +1,253 @@
+#ifndef GENERIC_COUNT_H_
+#define GENERIC_COUNT_H_
+
+#include <vector>
+#include <string>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	count_value works with any iterator, but when the iterators point into
+ *	contiguous memory (std::vector, std::array, std::string or a C array)
+ *	and the elements are plain numbers, the elements can be compared many
+ *	at a time with SIMD instructions instead of one by one.
+ *
+ *	The SIMD kernels are chosen when the program is compiled:
+ *	- AVX-512 when built with -mavx512bw (or -march=native on such a CPU)
+ *	- AVX2 when built with -mavx2
+ *	- otherwise a branch free loop that the compiler may vectorise itself
+ *	Other iterators, such as those of std::list, keep the plain loop.
+ */
+
+/**
+ * True for iterators that are known to walk through contiguous memory
+ */
+template <typename Iterator>
+struct is_contiguous_iterator
+{
+	using Value = typename std::iterator_traits<Iterator>::value_type;
+
+	static constexpr bool value = std::is_pointer<Iterator>::value
+		|| std::is_same<Iterator, typename std::vector<Value>::iterator>::value
+		|| std::is_same<Iterator,
+			typename std::vector<Value>::const_iterator>::value
+		|| std::is_same<Iterator, std::string::iterator>::value
+		|| std::is_same<Iterator, std::string::const_iterator>::value;
+};
+
+// std::vector<bool> packs its elements into bits, so it is never contiguous
+template <>
+struct is_contiguous_iterator<std::vector<bool>::iterator>
+{
+	static constexpr bool value = false;
+};
+
+template <>
+struct is_contiguous_iterator<std::vector<bool>::const_iterator>
+{
+	static constexpr bool value = false;
+};
+
+
+/**
+ * Counts the elements of data[0 .. size) equal to seek without branching
+ */
+template <typename Type>
+std::ptrdiff_t count_equal_scalar(const Type* data, std::size_t size,
+		Type seek)
+{
+	std::ptrdiff_t count = 0;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		count += data[i] == seek;
+	}
+	return count;
+}
+
+
+#if defined(__AVX512BW__)
+/**
+ * Compares 64 bytes at a time; each comparison yields one mask bit per
+ * element, so counting matches is a single popcount
+ */
+template <typename Type>
+std::ptrdiff_t count_equal_simd(const Type* data, std::size_t size, Type seek)
+{
+	const std::size_t LANES = 64 / sizeof(Type);
+	std::ptrdiff_t count = 0;
+	std::size_t i = 0;
+
+	if constexpr (std::is_integral<Type>::value)
+	{
+		__m512i needle;
+		switch (sizeof(Type))
+		{
+			case 1: needle = _mm512_set1_epi8(static_cast<char>(seek)); break;
+			case 2: needle = _mm512_set1_epi16(static_cast<short>(seek)); break;
+			case 4: needle = _mm512_set1_epi32(static_cast<int>(seek)); break;
+			default: needle = _mm512_set1_epi64(static_cast<long long>(seek));
+		}
+		for (; i + LANES <= size; i += LANES)
+		{
+			__m512i block = _mm512_loadu_si512(data + i);
+			std::uint64_t mask;
+			switch (sizeof(Type))
+			{
+				case 1: mask = _mm512_cmpeq_epi8_mask(block, needle); break;
+				case 2: mask = _mm512_cmpeq_epi16_mask(block, needle); break;
+				case 4: mask = _mm512_cmpeq_epi32_mask(block, needle); break;
+				default: mask = _mm512_cmpeq_epi64_mask(block, needle);
+			}
+			count += __builtin_popcountll(mask);
+		}
+	}
+	else if constexpr (sizeof(Type) == 4)
+	{
+		__m512 needle = _mm512_set1_ps(static_cast<float>(seek));
+		for (; i + LANES <= size; i += LANES)
+		{
+			__m512 block = _mm512_loadu_ps(
+					reinterpret_cast<const float*>(data + i));
+			count += __builtin_popcount(
+					_mm512_cmp_ps_mask(block, needle, _CMP_EQ_OQ));
+		}
+	}
+	else if constexpr (sizeof(Type) == 8)
+	{
+		__m512d needle = _mm512_set1_pd(static_cast<double>(seek));
+		for (; i + LANES <= size; i += LANES)
+		{
+			__m512d block = _mm512_loadu_pd(
+					reinterpret_cast<const double*>(data + i));
+			count += __builtin_popcount(
+					_mm512_cmp_pd_mask(block, needle, _CMP_EQ_OQ));
+		}
+	}
+
+	return count + count_equal_scalar(data + i, size - i, seek);
+}
+
+#elif defined(__AVX2__)
+/**
+ * Compares 32 bytes at a time. movemask gathers one bit per byte of the
+ * comparison result, so its popcount is the number of matching bytes.
+ */
+template <typename Type>
+std::ptrdiff_t count_equal_simd(const Type* data, std::size_t size, Type seek)
+{
+	const std::size_t LANES = 32 / sizeof(Type);
+	std::ptrdiff_t count = 0;
+	std::size_t i = 0;
+
+	if constexpr (std::is_integral<Type>::value)
+	{
+		__m256i needle;
+		switch (sizeof(Type))
+		{
+			case 1: needle = _mm256_set1_epi8(static_cast<char>(seek)); break;
+			case 2: needle = _mm256_set1_epi16(static_cast<short>(seek)); break;
+			case 4: needle = _mm256_set1_epi32(static_cast<int>(seek)); break;
+			default: needle = _mm256_set1_epi64x(static_cast<long long>(seek));
+		}
+		std::ptrdiff_t matching_bytes = 0;
+		for (; i + LANES <= size; i += LANES)
+		{
+			__m256i block = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i*>(data + i));
+			__m256i equal;
+			switch (sizeof(Type))
+			{
+				case 1: equal = _mm256_cmpeq_epi8(block, needle); break;
+				case 2: equal = _mm256_cmpeq_epi16(block, needle); break;
+				case 4: equal = _mm256_cmpeq_epi32(block, needle); break;
+				default: equal = _mm256_cmpeq_epi64(block, needle);
+			}
+			matching_bytes += __builtin_popcount(
+					static_cast<unsigned>(_mm256_movemask_epi8(equal)));
+		}
+		count = matching_bytes / sizeof(Type);
+	}
+	else if constexpr (sizeof(Type) == 4)
+	{
+		__m256 needle = _mm256_set1_ps(static_cast<float>(seek));
+		for (; i + LANES <= size; i += LANES)
+		{
+			__m256 block = _mm256_loadu_ps(
+					reinterpret_cast<const float*>(data + i));
+			count += __builtin_popcount(_mm256_movemask_ps(
+						_mm256_cmp_ps(block, needle, _CMP_EQ_OQ)));
+		}
+	}
+	else if constexpr (sizeof(Type) == 8)
+	{
+		__m256d needle = _mm256_set1_pd(static_cast<double>(seek));
+		for (; i + LANES <= size; i += LANES)
+		{
+			__m256d block = _mm256_loadu_pd(
+					reinterpret_cast<const double*>(data + i));
+			count += __builtin_popcount(_mm256_movemask_pd(
+						_mm256_cmp_pd(block, needle, _CMP_EQ_OQ)));
+		}
+	}
+
+	return count + count_equal_scalar(data + i, size - i, seek);
+}
+
+#else
+template <typename Type>
+std::ptrdiff_t count_equal_simd(const Type* data, std::size_t size, Type seek)
+{
+	return count_equal_scalar(data, size, seek);
+}
+#endif
+
+
+/**
+ * Count the elements in the range [iterator_begin, iterator_end) that match
+ * seek. Type Iterator is an iterator type working with a container that
+ * contains elements of type Type. Type Type elements must be compatible with
+ * operator==
+ */
+template <typename Iterator, typename Type>
+std::ptrdiff_t count_value(Iterator iterator_begin, Iterator iterator_end,
+		const Type& seek)
+{
+	using Value = typename std::iterator_traits<Iterator>::value_type;
+
+	// Numbers in contiguous memory go to the SIMD kernel. seek must already
+	// have the element type, so that no conversion changes what matches.
+	if constexpr (is_contiguous_iterator<Iterator>::value
+			&& std::is_arithmetic<Value>::value
+			&& !std::is_same<Value, bool>::value
+			&& std::is_same<Type, Value>::value)
+	{
+		std::size_t size = iterator_end - iterator_begin;
+		if (size == 0)
+		{
+			return 0;
+		}
+		return count_equal_simd(&*iterator_begin, size, seek);
+	}
+	else
+	{
+		std::ptrdiff_t count = 0;
+		for (auto cursor = iterator_begin; cursor != iterator_end;
+				cursor++)
+		{
+			if (*cursor == seek)
+			{
+				count++;
+			}
+		}
+		return count;
+	}
+}
+
+#endif
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <string>
+#include <thread>
+#include <functional>
+#include <cstdlib>
+
+#include "generic_count.h"
+#include "count_values.h"
+#include "timing.h"
+
+struct Point
+{
+	int x;
+	int y;
+
+	bool operator==(const Point& other) const
+	{
+		return x == other.x && y == other.y;
+	}
+};
+
+/**
+ * Points have no std::hash, so count_values is given this one
+ */
+struct PointHash
+{
+	std::size_t operator()(const Point& point) const
+	{
+		return std::hash<int>()(point.x) * 31 + std::hash<int>()(point.y);
+	}
+};
+
+
+template <typename Type>
+void print_counts(const std::vector<Type>& seeks,
+		const std::vector<std::ptrdiff_t>& counts)
+{
+	for (std::size_t i = 0; i < seeks.size(); i++)
+	{
+		std::cout << seeks[i] << ": " << counts[i] << "  ";
+	}
+	std::cout << "\n";
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::cout << "----------------- Vector of Integers  ------------------\n";
+	std::vector<int> values {34, 5, 12, 5, 8, 5, 11, 2};
+	std::vector<int> seeks {5, 12, 13, 8};
+	print_counts(seeks, count_values(std::begin(values), std::end(values),
+				seeks));
+
+	std::cout << "--------------- Linked List of Strings ----------------\n";
+	std::list<std::string> words {"mae", "al", "pat", "mel", "al", "ray",
+		"al"};
+	std::vector<std::string> names {"al", "mel", "bob"};
+	print_counts(names, count_values(std::begin(words), std::end(words),
+				names));
+
+	std::cout << "------------ Primitive C array of Points ---------------\n";
+	Point points[] = {{5, 3}, {0, 0}, {3, 5}, {5, 3}, {2, 1}};
+	std::vector<Point> targets {{5, 3}, {3, 5}, {7, 7}};
+	auto point_counts = count_values(std::begin(points), std::end(points),
+			targets, PointHash());
+	for (std::size_t i = 0; i < targets.size(); i++)
+	{
+		std::cout << "(" << targets[i].x << ", " << targets[i].y << "): "
+			<< point_counts[i] << "  ";
+	}
+	std::cout << "\n";
+
+	std::cout << "------------- One pass against k passes ---------------\n";
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 64 * 1024 * 1024;
+	std::vector<int> large(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		large[i] = static_cast<int>((i * 2654435761u) % 1000);
+	}
+
+	for (int key_count : {4, 64})
+	{
+		std::vector<int> keys;
+		for (int k = 0; k < key_count; k++)
+		{
+			keys.push_back(k * 7);
+		}
+
+		std::vector<std::ptrdiff_t> separate, together, parallel;
+		double separate_time = time_msec([&] ()
+			{
+				for (int key : keys)
+				{
+					separate.push_back(count_value(std::begin(large),
+								std::end(large), key));
+				}
+			});
+		double together_time = time_msec([&] ()
+			{
+				together = count_values(std::begin(large), std::end(large), keys);
+			});
+		unsigned threads = std::thread::hardware_concurrency();
+		double parallel_time = time_msec([&] ()
+			{
+				parallel = count_values_parallel(std::begin(large),
+						std::end(large), keys, threads);
+			});
+
+		std::cout << key_count << " keys: " << key_count << " x count_value "
+			<< separate_time << " msec, count_values "
+			<< together_time << " msec, " << threads << " threads "
+			<< parallel_time << " msec, agree: " << std::boolalpha
+			<< (separate == together && together == parallel) << "\n";
+	}
+}
@@ -1,11 +1,18 @@
 #include <iostream>
 #include <vector>
 
+#include "strided_view.h"
 
+
+/**
+ * Prints every increment-th value from the front. Stepping a plain iterator
+ * with += jumps past end() when the size is not a multiple of increment, so
+ * the loop walks a strided view that always stops exactly at its end.
+ */
 void print(const std::vector<int>& values, int increment)
 {
-	for (auto iter = std::begin(values); iter != std::end(values); 
-			iter += increment)
+	auto view = make_strided(std::begin(values), std::end(values), increment);
+	for (auto iter = std::begin(view); iter != std::end(view); iter++)
 	{
 		std::cout << *iter << "\n";
 	}
@@ -13,12 +20,22 @@ void print(const std::vector<int>& values, int increment)
 }
 
 
+/**
+ * Prints every decrement-th value stepping back from the end, starting with
+ * the one decrement places before end()
+ */
 void print_reverse(const std::vector<int>& values, int decrement)
 {
-	auto iter = std::end(values);
-	while (iter != std::begin(values))
+	if (decrement < 1 || decrement > static_cast<int>(values.size()))
+	{
+		std::cout << "\n";
+		return;
+	}
+
+	auto view = make_strided(std::rbegin(values) + (decrement - 1),
+			std::rend(values), decrement);
+	for (auto iter = std::begin(view); iter != std::end(view); iter++)
 	{
-		iter -= decrement;
 		std::cout << *iter << " ";
 	}
 	std::cout << "\n";
@@ -36,10 +53,12 @@ int main()
 	print(values, 1);
 	print(values, 2);
 	print(values, 3);
-	//print(values, 5); /* RESULTED IN SEGMENTATION FAULT: "INVESTIGATING" */
+	print(values, 5);
+	print(values, 7);
 
 	std::cout << "\n";
 	print_reverse(values, 4);
 	print_reverse(values, 1);
 	print_reverse(values, 2);
+	print_reverse(values, 3);
 }
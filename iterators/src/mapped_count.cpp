@@ -0,0 +1,92 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdlib>
+#include <cstdio>
+
+#include "generic_count.h"
+#include "mapped_file.h"
+#include "timing.h"
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 32 * 1024 * 1024;
+	const char* binary_path = "mapped_count.bin";
+	const char* text_path = "mapped_count.txt";
+
+	// Write the same integers as binary records and as lines of text
+	{
+		std::vector<int> values(size);
+		for (std::size_t i = 0; i < size; i++)
+		{
+			values[i] = static_cast<int>(i % 1000);
+		}
+		std::ofstream binary(binary_path, std::ios::binary);
+		binary.write(reinterpret_cast<const char*>(values.data()),
+				values.size() * sizeof(int));
+		std::ofstream text(text_path);
+		std::copy(std::begin(values), std::end(values),
+				std::ostream_iterator<int>(text, "\n"));
+	}
+
+	// Binary records: read into a vector, or count straight from the mapping
+	std::ptrdiff_t read_count = 0, mapped_count = 0;
+	double read_time = time_msec([&] ()
+		{
+			std::ifstream input(binary_path, std::ios::binary);
+			std::vector<int> values(size);
+			input.read(reinterpret_cast<char*>(values.data()),
+					values.size() * sizeof(int));
+			read_count = count_value(std::begin(values), std::end(values), 5);
+		});
+	double mapped_time = time_msec([&] ()
+		{
+			MappedFile file(binary_path);
+			RecordView<int> records(file);
+			mapped_count = count_value(std::begin(records), std::end(records), 5);
+		});
+	std::cout << "binary: ifstream + vector " << read_time << " msec ("
+		<< read_count << "), mapped " << mapped_time << " msec ("
+		<< mapped_count << ")\n";
+
+	// Text: std::istream_iterator, or std::from_chars over the mapping
+	double stream_time = time_msec([&] ()
+		{
+			std::ifstream input(text_path);
+			read_count = count_value(std::istream_iterator<int>(input),
+					std::istream_iterator<int>(), 5);
+		});
+	double token_time = time_msec([&] ()
+		{
+			MappedFile file(text_path);
+			IntegerTokens<int> tokens(file);
+			mapped_count = count_value(std::begin(tokens), std::end(tokens), 5);
+		});
+	std::cout << "text: istream_iterator " << stream_time << " msec ("
+		<< read_count << "), mapped tokens " << token_time << " msec ("
+		<< mapped_count << ")\n";
+
+	// Other algorithms run over the file contents the same way
+	MappedFile file(binary_path);
+	if (!file.is_open())
+	{
+		std::cout << "Could not open " << binary_path << "\n";
+		return 1;
+	}
+	RecordView<int> records(file);
+	auto found = std::find(std::begin(records), std::end(records), 999);
+	std::cout << "999 first found at record " << found - std::begin(records) << "\n";
+
+	std::vector<long long> squares(std::min<std::size_t>(records.size(), 10));
+	std::transform(std::begin(records), std::begin(records) + squares.size(),
+			std::begin(squares), [] (int x) { return 1LL * x * x; });
+	std::copy(std::begin(squares), std::end(squares),
+			std::ostream_iterator<long long>(std::cout, " "));
+	std::cout << "\n";
+
+	std::remove(binary_path);
+	std::remove(text_path);
+}
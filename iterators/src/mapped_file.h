@@ -0,0 +1,318 @@
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <charconv>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * NOTE:
+ *	Reading a file through std::ifstream copies every byte from the kernel
+ *	into the stream's buffer and then again into the program's variables.
+ *	Mapping the file with mmap makes its pages part of the program's memory
+ *	instead, so algorithms can run straight over the file contents with no
+ *	copy at all; the kernel reads pages in as they are first touched.
+ *
+ *	Algorithms usually walk a file from front to back, so by default the
+ *	mapping is marked with madvise(MADV_SEQUENTIAL), which makes the kernel
+ *	read further ahead and drop pages soon after they have been passed.
+ *
+ *	Like std::ifstream, a MappedFile that could not be opened is not an
+ *	error by itself; check is_open().
+ */
+class MappedFile
+{
+	const char* contents;
+	std::size_t length;
+	bool opened;
+
+	void release()
+	{
+		if (contents)
+		{
+			::munmap(const_cast<char*>(contents), length);
+		}
+		contents = nullptr;
+		length = 0;
+		opened = false;
+	}
+
+	public:
+	explicit MappedFile(const char* path, int advice = MADV_SEQUENTIAL) :
+		contents(nullptr), length(0), opened(false)
+	{
+		int descriptor = ::open(path, O_RDONLY);
+		if (descriptor < 0)
+		{
+			return;
+		}
+
+		struct stat status;
+		if (::fstat(descriptor, &status) == 0)
+		{
+			length = status.st_size;
+
+			// An empty file cannot be mapped, but it is still a valid file
+			if (length == 0)
+			{
+				opened = true;
+			}
+			else
+			{
+				void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE,
+						descriptor, 0);
+				if (address != MAP_FAILED)
+				{
+					contents = static_cast<const char*>(address);
+					opened = true;
+					::madvise(address, length, advice);
+				}
+				else
+				{
+					length = 0;
+				}
+			}
+		}
+
+		// The mapping stays valid after the descriptor is closed
+		::close(descriptor);
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) :
+		contents(other.contents), length(other.length), opened(other.opened)
+	{
+		other.contents = nullptr;
+		other.length = 0;
+		other.opened = false;
+	}
+
+	MappedFile& operator=(MappedFile&& other)
+	{
+		if (this != &other)
+		{
+			release();
+			contents = other.contents;
+			length = other.length;
+			opened = other.opened;
+			other.contents = nullptr;
+			other.length = 0;
+			other.opened = false;
+		}
+		return *this;
+	}
+
+	~MappedFile()
+	{
+		release();
+	}
+
+	bool is_open() const
+	{
+		return opened;
+	}
+
+	const char* data() const
+	{
+		return contents;
+	}
+
+	std::size_t size() const
+	{
+		return length;
+	}
+
+	const char* begin() const
+	{
+		return contents;
+	}
+
+	const char* end() const
+	{
+		return contents + length;
+	}
+};
+
+
+/**
+ * A file of fixed size binary records seen as an array of Record. The
+ * iterators are plain pointers into the mapping, so count_value and the
+ * other algorithms treat the file like a std::vector, SIMD paths included.
+ * Bytes after the last whole record are ignored.
+ *
+ * Records are read in the machine's own byte order and layout, so the file
+ * must have been written by a program using the same Record type.
+ */
+template <typename Record>
+class RecordView
+{
+	static_assert(std::is_trivially_copyable<Record>::value,
+			"RecordView needs records that can be copied as raw bytes");
+
+	const Record* first;
+	std::size_t count;
+
+	public:
+	using iterator = const Record*;
+
+	explicit RecordView(const MappedFile& file) :
+		first(reinterpret_cast<const Record*>(file.data())),
+		count(file.size() / sizeof(Record)) {}
+
+	iterator begin() const
+	{
+		return first;
+	}
+
+	iterator end() const
+	{
+		return first + count;
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	const Record& operator[](std::size_t index) const
+	{
+		return first[index];
+	}
+};
+
+
+/**
+ * Input iterator that reads whitespace separated integers from a range of
+ * characters with std::from_chars, the in-memory equivalent of
+ * std::istream_iterator<Integer>. As with std::istream_iterator, a token
+ * that is not a number ends the sequence.
+ */
+template <typename Integer>
+class IntegerTokenIterator
+{
+	static_assert(std::is_integral<Integer>::value,
+			"IntegerTokenIterator reads integers");
+
+	const char* position;
+	const char* last;
+	Integer value;
+
+	static bool is_space(char c)
+	{
+		return c == ' ' || c == '\n' || c == '\t' || c == '\r'
+			|| c == '\v' || c == '\f';
+	}
+
+	void read()
+	{
+		while (position != last && is_space(*position))
+		{
+			position++;
+		}
+
+		auto result = std::from_chars(position, last, value);
+		if (position == last || result.ec != std::errc())
+		{
+			// Become the end iterator
+			position = nullptr;
+			last = nullptr;
+			return;
+		}
+		position = result.ptr;
+	}
+
+	public:
+	using iterator_category = std::input_iterator_tag;
+	using value_type = Integer;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const Integer*;
+	using reference = const Integer&;
+
+	// The end iterator
+	IntegerTokenIterator() : position(nullptr), last(nullptr), value() {}
+
+	IntegerTokenIterator(const char* first, const char* last) :
+		position(first), last(last), value()
+	{
+		read();
+	}
+
+	const Integer& operator*() const
+	{
+		return value;
+	}
+
+	const Integer* operator->() const
+	{
+		return &value;
+	}
+
+	IntegerTokenIterator& operator++()
+	{
+		read();
+		return *this;
+	}
+
+	IntegerTokenIterator operator++(int)
+	{
+		IntegerTokenIterator old = *this;
+		read();
+		return old;
+	}
+
+	bool operator==(const IntegerTokenIterator& other) const
+	{
+		return position == other.position;
+	}
+
+	bool operator!=(const IntegerTokenIterator& other) const
+	{
+		return position != other.position;
+	}
+};
+
+
+/**
+ * The integers written as text in a mapped file, for use with range for
+ * and the algorithms
+ */
+template <typename Integer>
+class IntegerTokens
+{
+	const char* first;
+	const char* last;
+
+	public:
+	using iterator = IntegerTokenIterator<Integer>;
+
+	explicit IntegerTokens(const MappedFile& file) :
+		first(file.begin()), last(file.end()) {}
+
+	IntegerTokens(const char* first, const char* last) :
+		first(first), last(last) {}
+
+	iterator begin() const
+	{
+		return iterator(first, last);
+	}
+
+	iterator end() const
+	{
+		return iterator();
+	}
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+
+#include "generic_count.h"
+#include "chunked_list.h"
+#include "parallel_count.h"
+#include "timing.h"
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 64 * 1024 * 1024;
+	unsigned max_threads = argc > 2 ? std::atoi(argv[2])
+		: std::max(4u, std::thread::hardware_concurrency());
+
+	std::vector<int> values(size);
+	ChunkedList<int> chunks;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		values[i] = static_cast<int>(i % 1000);
+		chunks.push_back(values[i]);
+	}
+	std::list<int> small_list(std::begin(values), std::begin(values) + 100000);
+
+	std::ptrdiff_t expected = count_value(std::begin(values), std::end(values), 5);
+	std::cout << "Counting 5 among " << size << " integers (" << expected
+		<< " expected)\n";
+	std::cout << "threads    vector (msec)    chunked list (msec)\n";
+
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+	{
+		WorkStealingPool pool(threads);
+		std::ptrdiff_t vector_count, chunk_count;
+		double vector_time = time_msec([&] ()
+			{
+				vector_count = parallel_count_value(pool, std::begin(values),
+						std::end(values), 5);
+			});
+		double chunk_time = time_msec([&] ()
+			{
+				chunk_count = parallel_count_value(pool, std::begin(chunks),
+						std::end(chunks), 5);
+			});
+
+		std::cout << threads << "          " << vector_time << "          "
+			<< chunk_time;
+		if (vector_count != expected || chunk_count != expected)
+		{
+			std::cout << "    MISMATCH";
+		}
+		std::cout << "\n";
+	}
+
+	// A std::list cannot be split, so it is counted serially
+	WorkStealingPool pool(2);
+	std::cout << "std::list of 100000: " << parallel_count_value(pool,
+			std::begin(small_list), std::end(small_list), 5) << "\n";
+}
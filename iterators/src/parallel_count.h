@@ -0,0 +1,142 @@
+#ifndef PARALLEL_COUNT_H_
+#define PARALLEL_COUNT_H_
+
+#include <deque>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+
+#include "generic_count.h"
+#include "segmented_iterator.h"
+#include "work_stealing_pool.h"
+
+/**
+ * NOTE:
+ *	Counts the elements of [begin, end) that match seek using the threads
+ *	of a WorkStealingPool. How the range is split depends on the iterator:
+ *	- Random access iterators (std::vector, std::array, C arrays) are cut
+ *	  into equal chunks of at least grain elements.
+ *	- Segmented iterators (see segmented_iterator.h) are cut at segment
+ *	  boundaries, with consecutive segments grouped until a task has about
+ *	  grain elements. Inside a segment the count runs on plain pointers.
+ *	- Anything else, such as std::list, cannot be split without walking it,
+ *	  so it is counted on the calling thread.
+ *	Every task writes its own count, and the counts are added at the end;
+ *	no task ever waits on another.
+ */
+template <typename Iterator, typename Type>
+std::ptrdiff_t parallel_count_value(WorkStealingPool& pool,
+		Iterator iterator_begin, Iterator iterator_end, const Type& seek,
+		std::size_t grain = 1 << 16)
+{
+	using Category = typename std::iterator_traits<Iterator>::iterator_category;
+	using Segmented = segmented_iterator_traits<Iterator>;
+
+	// std::deque never moves its elements as it grows, so tasks can keep
+	// pointers to their slots
+	std::deque<std::ptrdiff_t> counts;
+
+	if constexpr (std::is_base_of<std::random_access_iterator_tag,
+			Category>::value)
+	{
+		std::size_t size = iterator_end - iterator_begin;
+
+		// Enough tasks for stealing to even out the load, but no tiny ones
+		std::size_t tasks = pool.size() * 4;
+		if (size / grain < tasks)
+		{
+			tasks = size / grain > 0 ? size / grain : 1;
+		}
+
+		for (std::size_t t = 0; t < tasks; t++)
+		{
+			Iterator first = iterator_begin + size * t / tasks;
+			Iterator last = iterator_begin + size * (t + 1) / tasks;
+			counts.push_back(0);
+			std::ptrdiff_t* slot = &counts.back();
+			pool.submit([first, last, &seek, slot] ()
+				{
+					*slot = count_value(first, last, seek);
+				});
+		}
+		pool.wait();
+	}
+	else if constexpr (Segmented::is_segmented)
+	{
+		using Segment = typename Segmented::segment_iterator;
+		using Local = typename Segmented::local_iterator;
+
+		Segment first_segment = Segmented::segment(iterator_begin);
+		Segment last_segment = Segmented::segment(iterator_end);
+		if (iterator_begin == iterator_end)
+		{
+			return 0;
+		}
+		if (first_segment == last_segment)
+		{
+			return count_value(Segmented::local(iterator_begin),
+					Segmented::local(iterator_end), seek);
+		}
+
+		// Gather runs of segments into tasks of about grain elements. The
+		// first segment starts part way in and the last one stops part way.
+		Segment group = first_segment;
+		Local group_begin = Segmented::local(iterator_begin);
+		std::size_t group_size = 0;
+		for (Segment segment = first_segment; ; segment = Segmented::next(segment))
+		{
+			bool last = segment == last_segment;
+			Local local_begin = segment == first_segment
+				? Segmented::local(iterator_begin) : Segmented::begin(segment);
+			Local local_end = last
+				? Segmented::local(iterator_end) : Segmented::end(segment);
+			group_size += local_end - local_begin;
+
+			if (group_size >= grain || last)
+			{
+				counts.push_back(0);
+				std::ptrdiff_t* slot = &counts.back();
+				Segment stop = segment;
+				Local stop_local = local_end;
+				pool.submit([group, group_begin, stop, stop_local, &seek, slot] ()
+					{
+						std::ptrdiff_t count = 0;
+						for (Segment s = group; ; s = Segmented::next(s))
+						{
+							Local from = s == group ? group_begin
+								: Segmented::begin(s);
+							Local to = s == stop ? stop_local : Segmented::end(s);
+							count += count_value(from, to, seek);
+							if (s == stop)
+							{
+								break;
+							}
+						}
+						*slot = count;
+					});
+
+				if (last)
+				{
+					break;
+				}
+				group = Segmented::next(segment);
+				group_begin = Segmented::begin(group);
+				group_size = 0;
+			}
+		}
+		pool.wait();
+	}
+	else
+	{
+		return count_value(iterator_begin, iterator_end, seek);
+	}
+
+	std::ptrdiff_t total = 0;
+	for (std::ptrdiff_t count : counts)
+	{
+		total += count;
+	}
+	return total;
+}
+
+#endif
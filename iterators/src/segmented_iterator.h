@@ -0,0 +1,26 @@
+#ifndef SEGMENTED_ITERATOR_H_
+#define SEGMENTED_ITERATOR_H_
+
+/**
+ * NOTE:
+ *	Many containers are not one block of memory but a chain of blocks
+ *	(segments), each of which is contiguous. An algorithm that knows this
+ *	can work on each segment with a plain pointer loop, and can hand
+ *	different segments to different threads.
+ *
+ *	A container opts in by specialising segmented_iterator_traits for its
+ *	iterator type with is_segmented = true and these members:
+ *	- segment_iterator   identifies one segment
+ *	- local_iterator     walks the elements inside one segment
+ *	- segment(it)        the segment that iterator it is in
+ *	- local(it)          where it is inside that segment
+ *	- begin(s), end(s)   the local range of segment s
+ *	- next(s)            the segment after s
+ */
+template <typename Iterator>
+struct segmented_iterator_traits
+{
+	static constexpr bool is_segmented = false;
+};
+
+#endif
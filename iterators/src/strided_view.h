@@ -0,0 +1,245 @@
+#ifndef STRIDED_VIEW_H_
+#define STRIDED_VIEW_H_
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	Stepping an iterator with iter += stride until it equals end() only
+ *	works when the size of the range is a multiple of stride; otherwise
+ *	the iterator jumps over end() and walks off the container, which is
+ *	undefined behaviour.
+ *
+ *	A StridedIterator instead counts which element of the strided sequence
+ *	it is on: element i is base[i * stride], and a range of n elements has
+ *	(n + stride - 1) / stride of them. end() is one of those positions, so
+ *	it is always reached exactly.
+ *
+ *	StridedIterator is a random access iterator, so std::for_each,
+ *	std::copy, std::find, std::transform, std::iota and the rest accept
+ *	it. When stepping forward it also asks the CPU to prefetch the element
+ *	prefetch_distance steps ahead, so that large strides, which defeat the
+ *	hardware's own prefetching, do not wait on memory at every step.
+ */
+template <typename Iterator>
+class StridedIterator
+{
+	static_assert(std::is_base_of<std::random_access_iterator_tag,
+			typename std::iterator_traits<Iterator>::iterator_category>::value,
+			"StridedIterator needs a random access iterator");
+
+	public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = typename std::iterator_traits<Iterator>::value_type;
+	using difference_type = std::ptrdiff_t;
+	using pointer = typename std::iterator_traits<Iterator>::pointer;
+	using reference = typename std::iterator_traits<Iterator>::reference;
+
+	private:
+	Iterator base;
+	difference_type index;
+	difference_type stride;
+
+	// Number of elements in the strided sequence; prefetches never go past
+	// the last one
+	difference_type count;
+	difference_type prefetch_distance;
+
+	void prefetch() const
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		difference_type ahead = index + prefetch_distance;
+		if (prefetch_distance > 0 && ahead < count)
+		{
+			__builtin_prefetch(std::addressof(base[ahead * stride]));
+		}
+#endif
+	}
+
+	public:
+	StridedIterator() : base(), index(0), stride(1), count(0),
+		prefetch_distance(0) {}
+
+	StridedIterator(Iterator base, difference_type index,
+			difference_type stride, difference_type count,
+			difference_type prefetch_distance) :
+		base(base), index(index), stride(stride), count(count),
+		prefetch_distance(prefetch_distance) {}
+
+	reference operator*() const
+	{
+		return base[index * stride];
+	}
+
+	pointer operator->() const
+	{
+		return std::addressof(base[index * stride]);
+	}
+
+	reference operator[](difference_type offset) const
+	{
+		return base[(index + offset) * stride];
+	}
+
+	StridedIterator& operator++()
+	{
+		index++;
+		prefetch();
+		return *this;
+	}
+
+	StridedIterator operator++(int)
+	{
+		StridedIterator old = *this;
+		++*this;
+		return old;
+	}
+
+	StridedIterator& operator--()
+	{
+		index--;
+		return *this;
+	}
+
+	StridedIterator operator--(int)
+	{
+		StridedIterator old = *this;
+		--*this;
+		return old;
+	}
+
+	StridedIterator& operator+=(difference_type offset)
+	{
+		index += offset;
+		prefetch();
+		return *this;
+	}
+
+	StridedIterator& operator-=(difference_type offset)
+	{
+		index -= offset;
+		return *this;
+	}
+
+	StridedIterator operator+(difference_type offset) const
+	{
+		StridedIterator result = *this;
+		return result += offset;
+	}
+
+	friend StridedIterator operator+(difference_type offset,
+			const StridedIterator& iterator)
+	{
+		return iterator + offset;
+	}
+
+	StridedIterator operator-(difference_type offset) const
+	{
+		StridedIterator result = *this;
+		return result -= offset;
+	}
+
+	difference_type operator-(const StridedIterator& other) const
+	{
+		return index - other.index;
+	}
+
+	bool operator==(const StridedIterator& other) const
+	{
+		return index == other.index;
+	}
+
+	bool operator!=(const StridedIterator& other) const
+	{
+		return index != other.index;
+	}
+
+	bool operator<(const StridedIterator& other) const
+	{
+		return index < other.index;
+	}
+
+	bool operator>(const StridedIterator& other) const
+	{
+		return index > other.index;
+	}
+
+	bool operator<=(const StridedIterator& other) const
+	{
+		return index <= other.index;
+	}
+
+	bool operator>=(const StridedIterator& other) const
+	{
+		return index >= other.index;
+	}
+};
+
+
+/**
+ * The elements first[0], first[stride], first[2 * stride], ... that lie
+ * before last
+ */
+template <typename Iterator>
+class StridedView
+{
+	using difference_type = std::ptrdiff_t;
+
+	Iterator first;
+	difference_type stride;
+	difference_type count;
+	difference_type prefetch_distance;
+
+	public:
+	using iterator = StridedIterator<Iterator>;
+
+	StridedView(Iterator first, Iterator last, difference_type stride,
+			difference_type prefetch_distance = 8) :
+		first(first), stride(stride > 0 ? stride : 1),
+		count(0), prefetch_distance(prefetch_distance)
+	{
+		difference_type size = last - first;
+		count = size > 0 ? (size + this->stride - 1) / this->stride : 0;
+	}
+
+	iterator begin() const
+	{
+		return iterator(first, 0, stride, count, prefetch_distance);
+	}
+
+	iterator end() const
+	{
+		return iterator(first, count, stride, count, prefetch_distance);
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	typename iterator::reference operator[](difference_type index) const
+	{
+		return first[index * stride];
+	}
+};
+
+
+/**
+ * Convenience function so the iterator type does not have to be spelled out
+ */
+template <typename Iterator>
+StridedView<Iterator> make_strided(Iterator first, Iterator last,
+		std::ptrdiff_t stride, std::ptrdiff_t prefetch_distance = 8)
+{
+	return StridedView<Iterator>(first, last, stride, prefetch_distance);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <cstdlib>
+
+#include "generic_count.h"
+#include "timing.h"
+
+/**
+ * The original one element at a time loop, for comparison
+ */
+template <typename Iterator, typename Type>
+int count_value_loop(Iterator iterator_begin, Iterator iterator_end,
+		const Type& seek)
+{
+	int count = 0;
+	for (auto cursor = iterator_begin; cursor != iterator_end; cursor++)
+	{
+		if (*cursor == seek)
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+
+int main(int argc, char* argv[])
+{
+	// 256M integers fill 1 GB
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 256 * 1024 * 1024;
+	std::vector<int> values(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		values[i] = static_cast<int>(i % 1000);
+	}
+	double gigabytes = size * sizeof(int) / 1e9;
+
+	std::ptrdiff_t loop_count = 0, simd_count = 0;
+	double loop_seconds = time_msec([&] ()
+		{
+			loop_count = count_value_loop(std::begin(values), std::end(values), 5);
+		}) / 1000;
+	double simd_seconds = time_msec([&] ()
+		{
+			simd_count = count_value(std::begin(values), std::end(values), 5);
+		}) / 1000;
+
+	std::cout << "Counting 5 in " << gigabytes << " GB of integers\n";
+	std::cout << "One at a time: " << loop_count << " found, "
+		<< gigabytes / loop_seconds << " GB/s\n";
+	std::cout << "count_value:   " << simd_count << " found, "
+		<< gigabytes / simd_seconds << " GB/s\n";
+
+	// A list still takes the one at a time path
+	std::list<int> small_list(std::begin(values), std::begin(values) + 10000);
+	std::cout << "In a list of 10000: "
+		<< count_value(std::begin(small_list), std::end(small_list), 5) << "\n";
+}
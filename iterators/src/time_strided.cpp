@@ -0,0 +1,64 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <cstdlib>
+
+#include "strided_view.h"
+#include "timing.h"
+
+/**
+ * Sums every stride-th value by stepping a strided view
+ */
+long long strided_sum(const std::vector<int>& values, std::ptrdiff_t stride,
+		std::ptrdiff_t prefetch_distance)
+{
+	auto view = make_strided(std::begin(values), std::end(values), stride,
+			prefetch_distance);
+	long long sum = 0;
+	for (int value : view)
+	{
+		sum += value;
+	}
+	return sum;
+}
+
+
+int main(int argc, char* argv[])
+{
+	// The algorithms module works on strided views like on any other range
+	std::vector<int> small(10);
+	auto evens = make_strided(std::begin(small), std::end(small), 2);
+	std::iota(std::begin(evens), std::end(evens), 1);
+	std::transform(std::begin(evens), std::end(evens), std::begin(evens),
+			[] (int x) { return 10 * x; });
+	std::copy(std::begin(small), std::end(small),
+			std::ostream_iterator<int>(std::cout, " "));
+	std::cout << "\n";
+	std::cout << "find 30 at strided position "
+		<< std::find(std::begin(evens), std::end(evens), 30) - std::begin(evens)
+		<< ", " << std::count_if(std::begin(evens), std::end(evens),
+				[] (int x) { return x > 20; }) << " above 20\n\n";
+
+	// Large stride scans over a big array, with and without prefetching
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 256 * 1024 * 1024;
+	std::vector<int> values(size, 1);
+	std::cout << "stride    no prefetch (msec)    prefetch 16 ahead (msec)\n";
+	for (std::ptrdiff_t stride : {16, 64, 1024, 4099})
+	{
+		long long plain = 0, prefetched = 0;
+		double plain_time = time_msec([&] ()
+			{
+				plain = strided_sum(values, stride, 0);
+			});
+		double prefetch_time = time_msec([&] ()
+			{
+				prefetched = strided_sum(values, stride, 16);
+			});
+
+		std::cout << stride << "        " << plain_time << "        "
+			<< prefetch_time << (plain == prefetched ? "" : "    MISMATCH")
+			<< "\n";
+	}
+}
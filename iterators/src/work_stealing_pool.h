@@ -0,0 +1,214 @@
+#ifndef WORK_STEALING_POOL_H_
+#define WORK_STEALING_POOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	A pool of threads that share out tasks by work stealing. Every thread
+ *	has its own deque of tasks:
+ *	- A thread takes its next task from the back of its own deque, where
+ *	  the most recently submitted (and most cache friendly) work is.
+ *	- A thread with nothing left steals from the front of another thread's
+ *	  deque, where the oldest and usually largest pieces of work are.
+ *	Threads only touch each other's deques when they run out of work, so
+ *	there is no single queue for all of them to fight over.
+ *
+ *	A pool of n threads starts n - 1 workers; the thread that calls wait()
+ *	is the n-th and runs tasks until every submitted task has finished.
+ */
+class WorkStealingPool
+{
+	struct alignas(64) TaskQueue
+	{
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	// queues[0] belongs to whichever thread calls wait(), queues[i] to
+	// worker i
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	std::vector<std::thread> workers;
+
+	// Tasks waiting in some deque, and tasks submitted but not finished
+	std::atomic<long> queued;
+	std::atomic<long> unfinished;
+	std::atomic<bool> stopping;
+	std::atomic<unsigned> next_queue;
+
+	std::mutex sleep_lock;
+	std::condition_variable wake;
+
+	/**
+	 * The pool the calling thread is a worker of, if any, and its queue
+	 * there. The thread_local is shared by every pool, so the index only
+	 * counts when pool is the pool asking.
+	 */
+	struct Worker
+	{
+		const WorkStealingPool* pool;
+		std::size_t index;
+	};
+
+	static Worker& current_worker()
+	{
+		thread_local Worker worker = {nullptr, 0};
+		return worker;
+	}
+
+	bool take(std::size_t index, std::function<void()>& task)
+	{
+		TaskQueue& queue = *queues[index];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.tasks.empty())
+		{
+			return false;
+		}
+		task = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+		return true;
+	}
+
+	bool steal(std::size_t thief, std::function<void()>& task)
+	{
+		for (std::size_t offset = 1; offset < queues.size(); offset++)
+		{
+			TaskQueue& queue = *queues[(thief + offset) % queues.size()];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			if (!queue.tasks.empty())
+			{
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Runs one task if any can be found; returns false otherwise
+	 */
+	bool run_one(std::size_t index)
+	{
+		std::function<void()> task;
+		if (take(index, task) || steal(index, task))
+		{
+			queued--;
+			task();
+			if (--unfinished == 0)
+			{
+				std::lock_guard<std::mutex> guard(sleep_lock);
+				wake.notify_all();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void work(std::size_t index)
+	{
+		current_worker() = {this, index};
+		while (!stopping)
+		{
+			if (!run_one(index))
+			{
+				std::unique_lock<std::mutex> guard(sleep_lock);
+				wake.wait(guard, [this] ()
+					{
+						return stopping || queued > 0;
+					});
+			}
+		}
+	}
+
+	public:
+	explicit WorkStealingPool(unsigned threads) :
+		queued(0), unfinished(0), stopping(false), next_queue(0)
+	{
+		if (threads == 0)
+		{
+			threads = 1;
+		}
+		for (unsigned i = 0; i < threads; i++)
+		{
+			queues.emplace_back(new TaskQueue);
+		}
+		for (unsigned i = 1; i < threads; i++)
+		{
+			workers.emplace_back(&WorkStealingPool::work, this, i);
+		}
+	}
+
+	~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> guard(sleep_lock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	std::size_t size() const
+	{
+		return queues.size();
+	}
+
+	/**
+	 * Queues a task. Tasks submitted by one of this pool's workers go to its
+	 * own deque; others, including those from other pools' workers and from
+	 * the thread in wait(), are dealt out round robin.
+	 */
+	void submit(std::function<void()> task)
+	{
+		const Worker& worker = current_worker();
+		std::size_t index = worker.pool == this ? worker.index
+			: next_queue++ % queues.size();
+
+		unfinished++;
+		{
+			TaskQueue& queue = *queues[index];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			queue.tasks.push_back(std::move(task));
+		}
+		{
+			std::lock_guard<std::mutex> guard(sleep_lock);
+			queued++;
+		}
+		wake.notify_one();
+	}
+
+	/**
+	 * Helps run tasks until all submitted tasks have finished
+	 */
+	void wait()
+	{
+		while (unfinished > 0)
+		{
+			if (!run_one(0))
+			{
+				std::unique_lock<std::mutex> guard(sleep_lock);
+				wake.wait(guard, [this] ()
+					{
+						return unfinished == 0 || queued > 0;
+					});
+			}
+		}
+	}
+};
+
+#endif
@@ -1,7 +1,10 @@
 #include <iostream>
-#include <functional>
+#include <vector>
 
-int evaluate2(std::function<int (int, int)> function, int value_x, int value_y)
+#include "function_ref.h"
+#include "evaluate_batch.h"
+
+int evaluate2(FunctionRef<int (int, int)> function, int value_x, int value_y)
 {
 	return function(value_x, value_y);
 }
@@ -24,4 +27,18 @@ int main()
 			}
 			return value_x + value_y;
 		}, 2, 3) << "\n";
+
+	// The same closure over whole columns of x and y. With select in place
+	// of the if, int columns are evaluated eight pairs at a time
+	std::vector<int> xs = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+	std::vector<int> ys(xs.size(), 3);
+	std::vector<int> results(xs.size());
+	evaluate_batch([value_a] (auto value_x, auto value_y)
+		{
+			return select(value_x == value_a, value_y, value_x + value_y + 1);
+		}, xs.data(), ys.data(), results.data(), xs.size());
+	for (std::size_t i = 0; i < xs.size(); i++)
+	{
+		std::cout << "(" << xs[i] << ", " << ys[i] << ") -> " << results[i] << "\n";
+	}
 }
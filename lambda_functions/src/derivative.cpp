@@ -1,22 +1,19 @@
 #include <iostream>
 #include <iomanip>
-#include <functional>
+#include <vector>
+#include <array>
+#include <cmath>
 
+#include "derivative.h"
+#include "dual.h"
 
-/**
- * Approximates the derivative of a function, f given an h value
- * The closer h is to zero, the better the estimate
- */
-std::function <double (double)> get_derivative (
-		std::function<double (double)> f, double h)
-{
-	return [f, h] (double x) { return (f(x + h) - f(x))/h; };
-}
 
 /**
- * The function we wish to differentiate
+ * The function we wish to differentiate, for doubles and for the dual
+ * numbers of automatic differentiation alike
  */
-double function(double x)
+template <typename Number>
+Number function(Number x)
 {
 	return 3 * x * x + 5;
 }
@@ -38,7 +35,7 @@ int main()
 
 	// Compute the function representing an approximation of the derivative of
 	// the function
-	auto derivative = get_derivative(function, h);
+	auto derivative = get_derivative(function<double>, h);
 
 	// Compare the computed derivative to the exact derivative derived 
 	// symbolically
@@ -55,4 +52,56 @@ int main()
 			<< derivative(x) << "    " << answer(x) << "\n";
 		x += 0.01;
 	}
+
+	// A fourth order central difference gets closer with a much larger h
+	double wide_h = 0.001;
+	auto central = get_central_derivative<4>(function<double>, wide_h);
+	std::cout << "\nCentral difference, order 4, h = " << wide_h << "\n";
+	std::cout << "    x        f'(x)     Actual f'(x)\n";
+	for (x = 5.0; x < 5.1; x += 0.05)
+	{
+		std::cout << std::setprecision(10) << x << "    " << central(x)
+			<< "    " << answer(x) << "\n";
+	}
+
+	// f and f' over a whole grid at once. The generic lambda also accepts
+	// packs of four doubles, so the grid is evaluated four points at a time
+	auto polynomial = [] (auto x) { return 3 * x * x + 5; };
+	std::vector<double> grid(8), values(8), slopes(8);
+	for (std::size_t i = 0; i < grid.size(); i++)
+	{
+		grid[i] = 5.0 + 0.01 * i;
+	}
+	evaluate_grid_packed<4>(polynomial, grid.data(), grid.size(), wide_h,
+			values.data(), slopes.data());
+	std::cout << "\nGrid evaluation\n";
+	for (std::size_t i = 0; i < grid.size(); i++)
+	{
+		std::cout << std::setprecision(5) << grid[i] << "    " << values[i]
+			<< "    " << slopes[i] << "\n";
+	}
+
+	// Dual numbers: one evaluation gives the value and the exact slope,
+	// with no h at all
+	std::cout << "\nAutomatic differentiation\n";
+	std::cout << "    x        f(x)          f'(x)     Actual f'(x)\n";
+	for (x = 5.0; x < 5.1; x += 0.05)
+	{
+		auto [value, slope] = differentiate(function<Dual<double>>, x);
+		std::cout << std::setprecision(10) << x << "    " << value << "    "
+			<< slope << "    " << answer(x) << "\n";
+	}
+
+	// The gradient of g(a, b, c) = a b + sin(c) / a in one pass
+	auto g = [] (const auto& v)
+	{
+		using std::sin;
+		return v[0] * v[1] + sin(v[2]) / v[0];
+	};
+	auto [value, gradient_at] = gradient<3>(g, {2.0, 3.0, 0.5});
+	std::cout << "\ng(2, 3, 0.5) = " << value << ", gradient = ("
+		<< gradient_at[0] << ", " << gradient_at[1] << ", " << gradient_at[2]
+		<< ")\n";
+	std::cout << "Actual gradient      = (" << 3.0 - std::sin(0.5) / 4 << ", "
+		<< 2.0 << ", " << std::cos(0.5) / 2 << ")\n";
 }
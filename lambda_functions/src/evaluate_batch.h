@@ -0,0 +1,422 @@
+#ifndef EVALUATE_BATCH_H_
+#define EVALUATE_BATCH_H_
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * NOTE:
+ *	Calling a closure once per (x, y) pair through a type erased wrapper
+ *	costs an indirect call per pair and hides the closure's body from the
+ *	compiler. evaluate_batch takes the closure as a template parameter
+ *	and applies it to whole columns, each given as a pointer to its first
+ *	element and one shared size: out[i] = function(x[i], y[i]).
+ *
+ *	A closure with an if in it cannot be vectorised as it stands, because
+ *	SIMD lanes cannot take different branches. Written with select
+ *	instead, both sides are computed and the condition picks between them:
+ *
+ *		[a] (auto x, auto y) { return select(x == a, y, x + y + 1); }
+ *
+ *	For int columns, a generic closure like this one is called with
+ *	IntPack arguments, eight ints at a time: an AVX2 register when built
+ *	with -mavx2, an array otherwise. Comparisons of packs give an IntMask
+ *	and select becomes a blend. A generic closure over int columns must
+ *	therefore only use what IntPack has: + - * & | ^, comparisons, select.
+ *	Closures that only take scalars, and other element types, run the
+ *	plain loop, which the compiler may still vectorise.
+ *
+ *	parallel_evaluate_batch cuts the columns into chunks of chunk elements
+ *	that the threads take in turn. Every output element is written by
+ *	exactly one thread, so the result is the same as the serial one.
+ */
+
+/**
+ * Lanes of an IntPack comparison: all ones where true, zero where false
+ */
+struct IntMask
+{
+#if defined(__AVX2__)
+	__m256i bits;
+
+	IntMask(__m256i bits) : bits(bits) {}
+
+	friend IntMask operator&(IntMask a, IntMask b)
+	{
+		return _mm256_and_si256(a.bits, b.bits);
+	}
+
+	friend IntMask operator|(IntMask a, IntMask b)
+	{
+		return _mm256_or_si256(a.bits, b.bits);
+	}
+
+	friend IntMask operator!(IntMask a)
+	{
+		return _mm256_xor_si256(a.bits, _mm256_set1_epi32(-1));
+	}
+#else
+	std::int32_t bits[8];
+
+	IntMask() = default;
+
+	friend IntMask operator&(IntMask a, IntMask b)
+	{
+		IntMask mask;
+		for (std::size_t i = 0; i < 8; i++)
+		{
+			mask.bits[i] = a.bits[i] & b.bits[i];
+		}
+		return mask;
+	}
+
+	friend IntMask operator|(IntMask a, IntMask b)
+	{
+		IntMask mask;
+		for (std::size_t i = 0; i < 8; i++)
+		{
+			mask.bits[i] = a.bits[i] | b.bits[i];
+		}
+		return mask;
+	}
+
+	friend IntMask operator!(IntMask a)
+	{
+		IntMask mask;
+		for (std::size_t i = 0; i < 8; i++)
+		{
+			mask.bits[i] = ~a.bits[i];
+		}
+		return mask;
+	}
+#endif
+};
+
+
+/**
+ * Eight ints handled together
+ */
+struct IntPack
+{
+	static constexpr std::size_t SIZE = 8;
+
+#if defined(__AVX2__)
+	__m256i values;
+
+	IntPack(__m256i values) : values(values) {}
+
+	IntPack(int value) : values(_mm256_set1_epi32(value)) {}
+
+	static IntPack load(const int* data)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+	}
+
+	void store(int* data) const
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), values);
+	}
+
+	friend IntPack operator+(IntPack a, IntPack b)
+	{
+		return _mm256_add_epi32(a.values, b.values);
+	}
+
+	friend IntPack operator-(IntPack a, IntPack b)
+	{
+		return _mm256_sub_epi32(a.values, b.values);
+	}
+
+	friend IntPack operator*(IntPack a, IntPack b)
+	{
+		return _mm256_mullo_epi32(a.values, b.values);
+	}
+
+	friend IntPack operator&(IntPack a, IntPack b)
+	{
+		return _mm256_and_si256(a.values, b.values);
+	}
+
+	friend IntPack operator|(IntPack a, IntPack b)
+	{
+		return _mm256_or_si256(a.values, b.values);
+	}
+
+	friend IntPack operator^(IntPack a, IntPack b)
+	{
+		return _mm256_xor_si256(a.values, b.values);
+	}
+
+	friend IntMask operator==(IntPack a, IntPack b)
+	{
+		return _mm256_cmpeq_epi32(a.values, b.values);
+	}
+
+	friend IntMask operator>(IntPack a, IntPack b)
+	{
+		return _mm256_cmpgt_epi32(a.values, b.values);
+	}
+
+	friend IntPack select(IntMask mask, IntPack a, IntPack b)
+	{
+		return _mm256_blendv_epi8(b.values, a.values, mask.bits);
+	}
+#else
+	int values[SIZE];
+
+	IntPack() = default;
+
+	IntPack(int value)
+	{
+		for (std::size_t i = 0; i < SIZE; i++)
+		{
+			values[i] = value;
+		}
+	}
+
+	static IntPack load(const int* data)
+	{
+		IntPack pack;
+		for (std::size_t i = 0; i < SIZE; i++)
+		{
+			pack.values[i] = data[i];
+		}
+		return pack;
+	}
+
+	void store(int* data) const
+	{
+		for (std::size_t i = 0; i < SIZE; i++)
+		{
+			data[i] = values[i];
+		}
+	}
+
+	template <typename Operation>
+	static IntPack apply(IntPack a, IntPack b, Operation operation)
+	{
+		IntPack result;
+		for (std::size_t i = 0; i < SIZE; i++)
+		{
+			result.values[i] = operation(a.values[i], b.values[i]);
+		}
+		return result;
+	}
+
+	template <typename Operation>
+	static IntMask compare(IntPack a, IntPack b, Operation operation)
+	{
+		IntMask mask;
+		for (std::size_t i = 0; i < SIZE; i++)
+		{
+			mask.bits[i] = operation(a.values[i], b.values[i]) ? -1 : 0;
+		}
+		return mask;
+	}
+
+	// Integer wraparound, as the SIMD instructions do
+	friend IntPack operator+(IntPack a, IntPack b)
+	{
+		return apply(a, b, [] (int x, int y)
+			{
+				return static_cast<int>(static_cast<unsigned>(x) + static_cast<unsigned>(y));
+			});
+	}
+
+	friend IntPack operator-(IntPack a, IntPack b)
+	{
+		return apply(a, b, [] (int x, int y)
+			{
+				return static_cast<int>(static_cast<unsigned>(x) - static_cast<unsigned>(y));
+			});
+	}
+
+	friend IntPack operator*(IntPack a, IntPack b)
+	{
+		return apply(a, b, [] (int x, int y)
+			{
+				return static_cast<int>(static_cast<unsigned>(x) * static_cast<unsigned>(y));
+			});
+	}
+
+	friend IntPack operator&(IntPack a, IntPack b)
+	{
+		return apply(a, b, [] (int x, int y) { return x & y; });
+	}
+
+	friend IntPack operator|(IntPack a, IntPack b)
+	{
+		return apply(a, b, [] (int x, int y) { return x | y; });
+	}
+
+	friend IntPack operator^(IntPack a, IntPack b)
+	{
+		return apply(a, b, [] (int x, int y) { return x ^ y; });
+	}
+
+	friend IntMask operator==(IntPack a, IntPack b)
+	{
+		return compare(a, b, [] (int x, int y) { return x == y; });
+	}
+
+	friend IntMask operator>(IntPack a, IntPack b)
+	{
+		return compare(a, b, [] (int x, int y) { return x > y; });
+	}
+
+	friend IntPack select(IntMask mask, IntPack a, IntPack b)
+	{
+		IntPack result;
+		for (std::size_t i = 0; i < SIZE; i++)
+		{
+			result.values[i] = mask.bits[i] ? a.values[i] : b.values[i];
+		}
+		return result;
+	}
+#endif
+
+	friend IntPack operator-(IntPack a)
+	{
+		return IntPack(0) - a;
+	}
+
+	friend IntMask operator!=(IntPack a, IntPack b)
+	{
+		return !(a == b);
+	}
+
+	friend IntMask operator<(IntPack a, IntPack b)
+	{
+		return b > a;
+	}
+
+	friend IntMask operator<=(IntPack a, IntPack b)
+	{
+		return !(a > b);
+	}
+
+	friend IntMask operator>=(IntPack a, IntPack b)
+	{
+		return !(b > a);
+	}
+};
+
+
+/**
+ * The scalar form of select, so the same closure works on single values
+ */
+template <typename Type>
+Type select(bool condition, Type a, Type b)
+{
+	return condition ? a : b;
+}
+
+
+namespace batch_detail
+{
+	/**
+	 * Whether function runs on packs: int columns, and a closure that takes
+	 * and returns IntPack. The closure is only tried on packs when the
+	 * columns are int.
+	 */
+	template <typename Function, bool Ints>
+	struct PackPath : std::false_type {};
+
+	template <typename Function>
+	struct PackPath<Function, true> : std::bool_constant<
+		std::is_invocable_r<IntPack, Function&, IntPack, IntPack>::value> {};
+
+	template <typename Function, typename X, typename Y, typename Result>
+	constexpr bool uses_packs = PackPath<Function,
+		std::is_same<std::remove_cv_t<X>, int>::value
+		&& std::is_same<std::remove_cv_t<Y>, int>::value
+		&& std::is_same<Result, int>::value>::value;
+
+	/**
+	 * out[i] = function(x[i], y[i]) for i in [begin, end)
+	 */
+	template <typename Function, typename X, typename Y, typename Result>
+	void run(Function& function, const X* x, const Y* y, Result* out,
+			std::size_t begin, std::size_t end)
+	{
+		std::size_t i = begin;
+		if constexpr (uses_packs<Function, X, Y, Result>)
+		{
+			for (; i + IntPack::SIZE <= end; i += IntPack::SIZE)
+			{
+				IntPack result = function(IntPack::load(x + i), IntPack::load(y + i));
+				result.store(out + i);
+			}
+		}
+		for (; i < end; i++)
+		{
+			out[i] = function(x[i], y[i]);
+		}
+	}
+}
+
+
+/**
+ * out[i] = function(x[i], y[i]) for i in [0, size)
+ */
+template <typename Function, typename X, typename Y, typename Result>
+void evaluate_batch(Function function, const X* x, const Y* y, Result* out,
+		std::size_t size)
+{
+	batch_detail::run(function, x, y, out, 0, size);
+}
+
+
+/**
+ * evaluate_batch on threads, chunk elements at a time; function is
+ * called from several threads at once
+ */
+template <typename Function, typename X, typename Y, typename Result>
+void parallel_evaluate_batch(Function function, const X* x, const Y* y,
+		Result* out, std::size_t size,
+		unsigned threads = std::thread::hardware_concurrency(),
+		std::size_t chunk = 1 << 16)
+{
+	chunk = chunk > 0 ? chunk : 1;
+	std::size_t chunks = (size + chunk - 1) / chunk;
+	if (threads > chunks)
+	{
+		threads = static_cast<unsigned>(chunks);
+	}
+	if (threads <= 1)
+	{
+		batch_detail::run(function, x, y, out, 0, size);
+		return;
+	}
+
+	std::atomic<std::size_t> next(0);
+	auto work = [&] ()
+	{
+		for (std::size_t c = next++; c < chunks; c = next++)
+		{
+			std::size_t end = (c + 1) * chunk < size ? (c + 1) * chunk : size;
+			batch_detail::run(function, x, y, out, c * chunk, end);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 1; t < threads; t++)
+	{
+		workers.emplace_back(work);
+	}
+	work();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+#endif
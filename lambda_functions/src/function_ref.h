@@ -0,0 +1,222 @@
+#ifndef FUNCTION_REF_H_
+#define FUNCTION_REF_H_
+
+#include <new>
+#include <utility>
+#include <memory>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	std::function owns a copy of whatever it wraps, and a capture larger
+ *	than its small internal buffer is copied to the heap. Every call then
+ *	goes through a pointer the compiler cannot see past. Two lighter
+ *	wrappers cover the common cases without ever allocating:
+ *
+ *	FunctionRef<Result (Args...)> only refers to a callable that lives
+ *	somewhere else: it is a pointer to the callable and a pointer to a
+ *	function that calls it, and costs nothing to make or copy. Use it for
+ *	parameters, where the callable outlives the call. Never keep one past
+ *	the statement that made it from a temporary lambda:
+ *
+ *		FunctionRef<int (int)> f = [] (int x) { return x; };   // dangles
+ *
+ *	InplaceFunction<Result (Args...), Capacity> owns its callable like
+ *	std::function, but stores it inside itself in Capacity bytes. A
+ *	callable that does not fit is a compile time error rather than a heap
+ *	allocation. Use it to store or return closures. Moving one never
+ *	throws, so a std::vector of them moves rather than copies when it
+ *	grows; the callable's own move constructor must not throw either.
+ */
+template <typename Signature>
+class FunctionRef;
+
+template <typename Signature, std::size_t Capacity = 32>
+class InplaceFunction;
+
+
+template <typename Result, typename... Args>
+class FunctionRef<Result (Args...)>
+{
+	// A plain function cannot be held in a void*, so it has its own member
+	union Target
+	{
+		void* object;
+		void (*function)();
+	};
+
+	Target target;
+	Result (*call)(Target, Args...);
+
+	public:
+	template <typename Function, typename = std::enable_if_t<
+		!std::is_same<std::decay_t<Function>, FunctionRef>::value
+		&& std::is_invocable_r<Result, Function&, Args...>::value>>
+	FunctionRef(Function&& function)
+	{
+		using Type = std::remove_reference_t<Function>;
+		if constexpr (std::is_function<Type>::value)
+		{
+			target.function = reinterpret_cast<void (*)()>(&function);
+			call = [] (Target target, Args... args) -> Result
+			{
+				return reinterpret_cast<Type*>(target.function)(
+						std::forward<Args>(args)...);
+			};
+		}
+		else
+		{
+			target.object = const_cast<void*>(
+					static_cast<const void*>(std::addressof(function)));
+			call = [] (Target target, Args... args) -> Result
+			{
+				return (*static_cast<Type*>(target.object))(
+						std::forward<Args>(args)...);
+			};
+		}
+	}
+
+	Result operator()(Args... args) const
+	{
+		return call(target, std::forward<Args>(args)...);
+	}
+};
+
+
+template <typename Result, typename... Args, std::size_t Capacity>
+class InplaceFunction<Result (Args...), Capacity>
+{
+	/**
+	 * What the stored callable's type knows how to do, one table per type
+	 */
+	struct Operations
+	{
+		Result (*call)(void*, Args...);
+		void (*copy)(void* to, const void* from);
+		void (*move)(void* to, void* from) noexcept;
+		void (*destroy)(void*) noexcept;
+	};
+
+	template <typename Function>
+	static const Operations* operations_for()
+	{
+		static const Operations operations = {
+			[] (void* object, Args... args) -> Result
+			{
+				return (*static_cast<Function*>(object))(std::forward<Args>(args)...);
+			},
+			[] (void* to, const void* from)
+			{
+				::new (to) Function(*static_cast<const Function*>(from));
+			},
+			[] (void* to, void* from) noexcept
+			{
+				::new (to) Function(std::move(*static_cast<Function*>(from)));
+			},
+			[] (void* object) noexcept
+			{
+				static_cast<Function*>(object)->~Function();
+			}
+		};
+		return &operations;
+	}
+
+	alignas(std::max_align_t) unsigned char storage[Capacity];
+	const Operations* operations;
+
+	public:
+	InplaceFunction() : operations(nullptr) {}
+
+	InplaceFunction(std::nullptr_t) : operations(nullptr) {}
+
+	template <typename Function, typename Type = std::decay_t<Function>,
+		typename = std::enable_if_t<
+			!std::is_same<Type, InplaceFunction>::value
+			&& std::is_invocable_r<Result, Type&, Args...>::value>>
+	InplaceFunction(Function&& function)
+	{
+		static_assert(sizeof(Type) <= Capacity,
+				"callable too large for this InplaceFunction's Capacity");
+		static_assert(alignof(Type) <= alignof(std::max_align_t),
+				"callable over-aligned for InplaceFunction");
+		static_assert(std::is_nothrow_move_constructible<Type>::value,
+				"callable's move constructor may throw");
+		::new (static_cast<void*>(storage)) Type(std::forward<Function>(function));
+		operations = operations_for<Type>();
+	}
+
+	InplaceFunction(const InplaceFunction& other) : operations(other.operations)
+	{
+		if (operations)
+		{
+			operations->copy(storage, other.storage);
+		}
+	}
+
+	InplaceFunction(InplaceFunction&& other) noexcept
+		: operations(other.operations)
+	{
+		if (operations)
+		{
+			operations->move(storage, other.storage);
+		}
+	}
+
+	InplaceFunction& operator=(const InplaceFunction& other)
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.operations)
+			{
+				other.operations->copy(storage, other.storage);
+				operations = other.operations;
+			}
+		}
+		return *this;
+	}
+
+	InplaceFunction& operator=(InplaceFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			if (other.operations)
+			{
+				other.operations->move(storage, other.storage);
+				operations = other.operations;
+			}
+		}
+		return *this;
+	}
+
+	~InplaceFunction()
+	{
+		reset();
+	}
+
+	void reset() noexcept
+	{
+		if (operations)
+		{
+			operations->destroy(storage);
+			operations = nullptr;
+		}
+	}
+
+	explicit operator bool() const
+	{
+		return operations != nullptr;
+	}
+
+	Result operator()(Args... args) const
+	{
+		assert(operations && "call of an empty InplaceFunction");
+		return operations->call(const_cast<unsigned char*>(storage),
+				std::forward<Args>(args)...);
+	}
+};
+
+#endif
@@ -1,7 +1,8 @@
 #include <iostream>
-#include <functional>
 
-std::function <int (int)> make_adder()
+#include "function_ref.h"
+
+InplaceFunction<int (int)> make_adder()
 {
 	int local_value = 2;
 	return [local_value] (int value_x) {return value_x + local_value;};
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <cstdlib>
+
+#include "function_ref.h"
+#include "evaluate_batch.h"
+#include "timing.h"
+
+int evaluate_erased(const std::function<int (int, int)>& function, int x, int y)
+{
+	return function(x, y);
+}
+
+int evaluate_ref(FunctionRef<int (int, int)> function, int x, int y)
+{
+	return function(x, y);
+}
+
+
+int main(int argc, char* argv[])
+{
+	// Columns small enough to stay in cache, evaluated rounds times, so
+	// the calls and not memory set the pace
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 1 << 14;
+	std::size_t rounds = argc > 2 ? std::atoll(argv[2]) : 3000;
+	unsigned threads = std::thread::hardware_concurrency();
+	threads = threads > 0 ? threads : 1;
+
+	std::vector<int> x(size), y(size), out(size), expected(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		x[i] = static_cast<int>((i * 2654435761u) % 7);
+		y[i] = static_cast<int>(i % 1000);
+	}
+	int a = 2;
+
+	// closure_in.cpp's closure as written, and with select
+	auto branchy = [a] (int value_x, int value_y)
+	{
+		if (value_x == a)
+		{
+			value_x = 0;
+		}
+		else
+		{
+			value_y++;
+		}
+		return value_x + value_y;
+	};
+	auto selecting = [a] (auto value_x, auto value_y)
+	{
+		return select(value_x == a, value_y, value_x + value_y + 1);
+	};
+
+	double erased_time = time_msec([&] ()
+		{
+			for (std::size_t r = 0; r < rounds; r++)
+			{
+				for (std::size_t i = 0; i < size; i++)
+				{
+					expected[i] = evaluate_erased(branchy, x[i], y[i]);
+				}
+			}
+		});
+	double ref_time = time_msec([&] ()
+		{
+			for (std::size_t r = 0; r < rounds; r++)
+			{
+				for (std::size_t i = 0; i < size; i++)
+				{
+					out[i] = evaluate_ref(branchy, x[i], y[i]);
+				}
+			}
+		});
+	bool correct = out == expected;
+
+	double branchy_time = time_msec([&] ()
+		{
+			for (std::size_t r = 0; r < rounds; r++)
+			{
+				evaluate_batch(branchy, x.data(), y.data(), out.data(), size);
+			}
+		});
+	correct = correct && out == expected;
+
+	double select_time = time_msec([&] ()
+		{
+			for (std::size_t r = 0; r < rounds; r++)
+			{
+				evaluate_batch(selecting, x.data(), y.data(), out.data(), size);
+			}
+		});
+	correct = correct && out == expected;
+
+	double parallel_time = time_msec([&] ()
+		{
+			for (std::size_t r = 0; r < rounds; r++)
+			{
+				parallel_evaluate_batch(selecting, x.data(), y.data(), out.data(),
+						size, threads, size / threads);
+			}
+		});
+	correct = correct && out == expected;
+
+	std::cout << rounds << " rounds of " << size << " pairs, msec\n";
+	std::cout << "evaluate2 with std::function:     " << erased_time << "\n";
+	std::cout << "evaluate2 with FunctionRef:       " << ref_time << "\n";
+	std::cout << "evaluate_batch, if/else closure:  " << branchy_time << "\n";
+	std::cout << "evaluate_batch, select closure:   " << select_time << "\n";
+	std::cout << "parallel_evaluate_batch, " << threads << " threads: "
+		<< parallel_time << "\n";
+	std::cout << (correct ? "All results agree\n" : "Results differ\n");
+}
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <cmath>
+#include <cstdlib>
+
+#include "derivative.h"
+#include "timing.h"
+
+/**
+ * The derivative as derivative.cpp first built it
+ */
+std::function<double (double)> get_derivative_erased(
+		std::function<double (double)> f, double h)
+{
+	return [f, h] (double x) { return (f(x + h) - f(x)) / h; };
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 10000000;
+
+	// A rational function, with its exact derivative for the error
+	auto f = [] (auto x) { return (x * x + 1) / (x + 3); };
+	auto exact = [] (double x) { return (x * x + 6 * x - 1) / ((x + 3) * (x + 3)); };
+
+	std::vector<double> grid(size), values(size), slopes(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		grid[i] = 0.5 + 10.0 * i / size;
+	}
+
+	auto max_error = [&] ()
+	{
+		double error = 0;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			error = std::max(error, std::abs(slopes[i] - exact(grid[i])));
+		}
+		return error;
+	};
+
+	double h = 1e-7;
+	auto erased = get_derivative_erased(f, h);
+	double erased_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				values[i] = f(grid[i]);
+				slopes[i] = erased(grid[i]);
+			}
+		});
+	double erased_error = max_error();
+
+	auto forward = get_derivative(f, h);
+	double forward_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				values[i] = f(grid[i]);
+				slopes[i] = forward(grid[i]);
+			}
+		});
+	double forward_error = max_error();
+
+	double central_time = time_msec([&] ()
+		{
+			evaluate_grid<4>(f, grid.data(), size, 1e-3, values.data(),
+					slopes.data());
+		});
+	double central_error = max_error();
+
+	double packed_time = time_msec([&] ()
+		{
+			evaluate_grid_packed<4>(f, grid.data(), size, 1e-3, values.data(),
+					slopes.data());
+		});
+	double packed_error = max_error();
+
+	std::cout << "f and f' at " << size << " points: msec, largest error\n";
+	std::cout << "std::function, forward, h = 1e-7: " << erased_time << "    "
+		<< erased_error << "\n";
+	std::cout << "template, forward, h = 1e-7:      " << forward_time << "    "
+		<< forward_error << "\n";
+	std::cout << "evaluate_grid, order 4, h = 1e-3: " << central_time << "    "
+		<< central_error << "\n";
+	std::cout << "evaluate_grid_packed, same:       " << packed_time << "    "
+		<< packed_error << "\n";
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+#include "derivative.h"
+#include "dual.h"
+#include "timing.h"
+
+constexpr std::size_t PARAMETERS = 8;
+
+/**
+ * A model with PARAMETERS parameters: a polynomial in x whose
+ * coefficients are the parameters, divided by 1 + p0^2
+ */
+template <typename Number>
+Number model(const std::array<Number, PARAMETERS>& p, double x)
+{
+	Number sum = p[PARAMETERS - 1];
+	for (std::size_t i = PARAMETERS - 1; i-- > 0; )
+	{
+		sum = sum * x + p[i];
+	}
+	return sum / (1 + p[0] * p[0]);
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 10000000;
+
+	// One variable: f and f' of a rational function at every grid point
+	auto f = [] (auto x) { return (x * x + 1) / (x + 3); };
+	auto exact = [] (double x) { return (x * x + 6 * x - 1) / ((x + 3) * (x + 3)); };
+
+	std::vector<double> grid(size), values(size), slopes(size);
+	for (std::size_t i = 0; i < size; i++)
+	{
+		grid[i] = 0.5 + 10.0 * i / size;
+	}
+
+	auto max_error = [&] ()
+	{
+		double error = 0;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			error = std::max(error, std::abs(slopes[i] - exact(grid[i])));
+		}
+		return error;
+	};
+
+	auto forward = get_derivative(f, 1e-7);
+	double forward_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				values[i] = f(grid[i]);
+				slopes[i] = forward(grid[i]);
+			}
+		});
+	double forward_error = max_error();
+
+	double central_time = time_msec([&] ()
+		{
+			evaluate_grid<4>(f, grid.data(), size, 1e-3, values.data(),
+					slopes.data());
+		});
+	double central_error = max_error();
+
+	double dual_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				auto [value, slope] = differentiate(f, grid[i]);
+				values[i] = value;
+				slopes[i] = slope;
+			}
+		});
+	double dual_error = max_error();
+
+	std::cout << "f and f' at " << size << " points: msec, largest error\n";
+	std::cout << "get_derivative, h = 1e-7:         " << forward_time << "    "
+		<< forward_error << "\n";
+	std::cout << "evaluate_grid, order 4, h = 1e-3: " << central_time << "    "
+		<< central_error << "\n";
+	std::cout << "Dual:                             " << dual_time << "    "
+		<< dual_error << "\n";
+
+	// Many variables: the gradient of the model with respect to all its
+	// parameters, at size / 10 values of x
+	std::size_t points = size / 10;
+	std::array<double, PARAMETERS> parameters;
+	for (std::size_t i = 0; i < PARAMETERS; i++)
+	{
+		parameters[i] = 0.5 / (i + 1);
+	}
+	double checksum = 0;
+
+	// Finite differences: one get_derivative per parameter, each moving
+	// that parameter alone
+	double difference_time = time_msec([&] ()
+		{
+			for (std::size_t k = 0; k < points; k++)
+			{
+				double x = 1.0 * k / points;
+				for (std::size_t i = 0; i < PARAMETERS; i++)
+				{
+					auto along = [&parameters, i, x] (double t)
+					{
+						std::array<double, PARAMETERS> p = parameters;
+						p[i] = t;
+						return model(p, x);
+					};
+					checksum += get_derivative(along, 1e-7)(parameters[i]);
+				}
+			}
+		});
+	double difference_sum = checksum;
+
+	checksum = 0;
+	double gradient_time = time_msec([&] ()
+		{
+			for (std::size_t k = 0; k < points; k++)
+			{
+				double x = 1.0 * k / points;
+				auto result = gradient<PARAMETERS>([x] (const auto& p)
+					{
+						return model(p, x);
+					}, parameters);
+				for (double slope : result.second)
+				{
+					checksum += slope;
+				}
+			}
+		});
+
+	std::cout << "\nGradient in " << PARAMETERS << " parameters at " << points
+		<< " points: msec, sum of the gradients\n";
+	std::cout << "get_derivative per parameter: " << difference_time << "    "
+		<< difference_sum << "\n";
+	std::cout << "Dual<double, " << PARAMETERS << ">:             "
+		<< gradient_time << "    " << checksum << "\n";
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <functional>
+#include <cstdlib>
+
+#include "function_ref.h"
+#include "timing.h"
+
+/**
+ * Calls function size times; the same loop for every kind of wrapper
+ */
+template <typename Function>
+long long call_many(const Function& function, std::size_t size)
+{
+	long long total = 0;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		total += function(static_cast<int>(i));
+	}
+	return total;
+}
+
+long long call_std_function(const std::function<int (int)>& function,
+		std::size_t size)
+{
+	return call_many(function, size);
+}
+
+long long call_function_ref(FunctionRef<int (int)> function, std::size_t size)
+{
+	return call_many(function, size);
+}
+
+long long call_inplace_function(const InplaceFunction<int (int)>& function,
+		std::size_t size)
+{
+	return call_many(function, size);
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 100000000;
+	long long check = 0;
+	int offset = 2;
+	auto adder = [offset] (int x) { return x + offset; };
+
+	// Calling: the same small closure behind each wrapper
+	double template_time = time_msec([&] () { check += call_many(adder, size); });
+	double std_time = time_msec([&] () { check += call_std_function(adder, size); });
+	double ref_time = time_msec([&] () { check += call_function_ref(adder, size); });
+	InplaceFunction<int (int)> stored = adder;
+	double inplace_time = time_msec([&] ()
+		{
+			check += call_inplace_function(stored, size);
+		});
+
+	// Making: a closure capturing 40 bytes, too much for std::function's
+	// internal buffer, wrapped afresh every time
+	std::size_t made = size / 10;
+	long long a = 1, b = 2, c = 3, d = 4, e = 5;
+	double std_make_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < made; i++)
+			{
+				std::function<int (int)> function = [a, b, c, d, e] (int x)
+				{
+					return static_cast<int>(x + a + b + c + d + e);
+				};
+				check += function(static_cast<int>(i));
+			}
+		});
+	double inplace_make_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < made; i++)
+			{
+				InplaceFunction<int (int), 48> function = [a, b, c, d, e] (int x)
+				{
+					return static_cast<int>(x + a + b + c + d + e);
+				};
+				check += function(static_cast<int>(i));
+			}
+		});
+
+	std::cout << size << " calls, msec\n";
+	std::cout << "template parameter: " << template_time << "\n";
+	std::cout << "std::function:      " << std_time << "\n";
+	std::cout << "FunctionRef:        " << ref_time << "\n";
+	std::cout << "InplaceFunction:    " << inplace_time << "\n";
+	std::cout << made << " closures of 40 bytes made and called, msec\n";
+	std::cout << "std::function:      " << std_make_time << "\n";
+	std::cout << "InplaceFunction:    " << inplace_make_time << "\n";
+	std::cout << "(check " << check << ")\n";
+}
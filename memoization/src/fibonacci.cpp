@@ -1,5 +1,5 @@
-#include <unordered_map>
 #include "fibonacci.h"
+#include "flat_hash_map.h"
 
 
 Integer fibonacci(unsigned n)
@@ -21,12 +21,18 @@ Integer fibonacci(unsigned n)
 
 Integer fibonacciTwo(unsigned n)
 {
-	static std::unordered_map<unsigned, Integer> memo{{0, 0}, {1, 1}};
-	if (n > 1 && memo[n] == 0)
+	static FlatHashMap<unsigned, Integer> memo{{0, 0}, {1, 1}};
+	auto found = memo.find(n);
+	if (found != memo.end())
 	{
-		memo[n] = fibonacciTwo(n - 2) + fibonacciTwo(n - 1);
+		return found->second;
 	}
-	return memo[n];
+
+	// Entries move when the table grows, so hold no reference into it
+	// across the recursive calls
+	Integer value = fibonacciTwo(n - 2) + fibonacciTwo(n - 1);
+	memo[n] = value;
+	return value;
 }
 
 
@@ -1,7 +1,8 @@
 #include <iostream>
-#include <map>
 
-std::map<int, int> call_counter;
+#include "flat_hash_map.h"
+
+FlatHashMap<int, int> call_counter;
 
 int fibonacci(int n)
 {
@@ -23,13 +24,20 @@ int fibonacci(int n)
 
 int main()
 {
-	std::cout << "fibonacci(35) = " << fibonacci(35) << "\n\n";
+	const int argument = 35;
+	std::cout << "fibonacci(" << argument << ") = " << fibonacci(argument)
+		<< "\n\n";
 	// Report the total number of calls to the fibonacci function
 	std::cout << "Argument Calls" << "\n";
 	std::cout << "---------------------" << "\n";
-	for (auto& counts : call_counter)
+	// A hash map keeps no order, so go through the arguments in turn
+	for (int n = 0; n <= argument; n++)
 	{
-		std::cout << " " << counts.first << "        " 
-			<< counts.second << "\n";
+		auto counts = call_counter.find(n);
+		if (counts != call_counter.end())
+		{
+			std::cout << " " << counts->first << "        "
+				<< counts->second << "\n";
+		}
 	}
 }
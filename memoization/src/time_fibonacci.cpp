@@ -1,11 +1,10 @@
 #include <iostream>
 #include <ctime>
-#include <functional>
 
 #include "fibonacci.h"
+#include "function_ref.h"
 
-unsigned time_it(const std::function<Integer(unsigned)>& function, 
-		unsigned n)
+unsigned time_it(FunctionRef<Integer (unsigned)> function, unsigned n)
 {
 	clock_t start_time = clock();
 	function(n);
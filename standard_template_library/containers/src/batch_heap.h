@@ -0,0 +1,165 @@
+#ifndef BATCH_HEAP_H_
+#define BATCH_HEAP_H_
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	A drop in for std::priority_queue<Type, Container, Compare> that also
+ *	moves items in and out in batches:
+ *	- push_range() builds the heap with Floyd's bottom-up heapify, which is
+ *	  O(n) instead of the O(n log n) of n single pushes. When the heap
+ *	  already holds many more items than arrive, sifting the newcomers up
+ *	  one by one is cheaper, and push_range() does that instead.
+ *	- pop_n() removes the k highest priority items into an output iterator
+ *	  in one call, highest first. A large k is served by selecting and
+ *	  sorting the k best items rather than popping them one at a time.
+ *	Compare works exactly as for std::priority_queue, so the Comparer
+ *	structs of the other demos plug straight in.
+ */
+template <typename Type, typename Container = std::vector<Type>,
+		 typename Compare = std::less<typename Container::value_type>>
+class BatchHeap
+{
+	Container items;
+	Compare compare;
+
+	/**
+	 * Floor of log2(value), for value > 0
+	 */
+	static std::size_t log2(std::size_t value)
+	{
+		std::size_t result = 0;
+		while (value >>= 1)
+		{
+			result++;
+		}
+		return result;
+	}
+
+	public:
+	BatchHeap(const Compare& compare = Compare()) : compare(compare) {}
+
+	bool empty() const
+	{
+		return items.empty();
+	}
+
+	std::size_t size() const
+	{
+		return items.size();
+	}
+
+	void reserve(std::size_t capacity)
+	{
+		items.reserve(capacity);
+	}
+
+	const Type& top() const
+	{
+		return items.front();
+	}
+
+	void push(const Type& value)
+	{
+		items.push_back(value);
+		std::push_heap(std::begin(items), std::end(items), compare);
+	}
+
+	void push(Type&& value)
+	{
+		items.push_back(std::move(value));
+		std::push_heap(std::begin(items), std::end(items), compare);
+	}
+
+	void pop()
+	{
+		std::pop_heap(std::begin(items), std::end(items), compare);
+		items.pop_back();
+	}
+
+	/**
+	 * Adds the items in [first, last) to the heap
+	 */
+	template <typename Iterator>
+	void push_range(Iterator first, Iterator last)
+	{
+		std::size_t old_size = items.size();
+		items.insert(std::end(items), first, last);
+		std::size_t count = items.size() - old_size;
+
+		// Sifting up costs about count * log2(size); heapify costs about
+		// size. Pick whichever is less work.
+		if (count * log2(items.size() + 1) >= items.size())
+		{
+			std::make_heap(std::begin(items), std::end(items), compare);
+		}
+		else
+		{
+			for (auto end = std::begin(items) + old_size + 1;
+					end <= std::end(items); ++end)
+			{
+				std::push_heap(std::begin(items), end, compare);
+			}
+		}
+	}
+
+	/**
+	 * Moves up to k of the highest priority items to output, highest first,
+	 * and returns the output iterator past the last one written
+	 */
+	template <typename OutputIterator>
+	OutputIterator pop_n(std::size_t k, OutputIterator output)
+	{
+		k = std::min(k, items.size());
+		if (k == 0)
+		{
+			return output;
+		}
+
+		// Popping costs about k * log2(size) scattered memory accesses.
+		// For large k it is cheaper to select the k best in O(n), sort just
+		// those, and heapify what is left.
+		if (k * log2(items.size()) >= items.size())
+		{
+			auto higher = [this] (const Type& one, const Type& two)
+			{
+				return compare(two, one);
+			};
+			auto middle = std::begin(items) + k;
+			std::nth_element(std::begin(items), middle, std::end(items),
+					higher);
+			std::sort(std::begin(items), middle, higher);
+			output = std::move(std::begin(items), middle, output);
+			items.erase(std::begin(items), middle);
+			std::make_heap(std::begin(items), std::end(items), compare);
+			return output;
+		}
+
+		// Each pop_heap parks the current top just past the shrinking heap,
+		// so the popped items pile up at the back in reverse order
+		auto end = std::end(items);
+		for (std::size_t i = 0; i < k; i++)
+		{
+			std::pop_heap(std::begin(items), end, compare);
+			--end;
+		}
+
+		output = std::move(std::make_reverse_iterator(std::end(items)),
+				std::make_reverse_iterator(end), output);
+		items.erase(end, std::end(items));
+		return output;
+	}
+
+	void clear()
+	{
+		items.clear();
+	}
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+#include <random>
+#include <iterator>
+#include <cstdlib>
+
+#include "batch_heap.h"
+#include "timing.h"
+
+struct Message
+{
+	int rank; // Lower number = Higher Priority
+	std::string text;
+
+	Message(const std::string& text, int rank) : rank(rank), text(text){}
+};
+
+struct MessageComparer
+{
+	bool operator()(const Message& messageOne, const Message& messageTwo) const
+	{
+		return messageTwo.rank < messageOne.rank;
+	}
+};
+
+struct Comparer
+{
+	bool operator()(int valueOne, int valueTwo) const
+	{
+		return valueTwo < valueOne;
+	}
+};
+
+
+int main(int argc, char* argv[])
+{
+	// priority_queue_simple.cpp, in one batch each way
+	std::vector<int> values {1, 2, 4, 15, 15, 4, 7};
+	BatchHeap<int> queue;
+	queue.push_range(std::begin(values), std::end(values));
+	queue.pop_n(queue.size(), std::ostream_iterator<int>(std::cout, " "));
+	std::cout << "\n";
+
+	// reverse_priority.cpp, draining only the three smallest
+	values = {3, 12, 11, 55, 2, 4};
+	BatchHeap<int, std::vector<int>, Comparer> reverse_queue;
+	reverse_queue.push_range(std::begin(values), std::end(values));
+	reverse_queue.pop_n(3, std::ostream_iterator<int>(std::cout, " "));
+	std::cout << "(" << reverse_queue.size() << " left)\n";
+
+	// message_priority.cpp
+	std::vector<Message> messages {{"Be there soon", 2},
+		{"Gimme a few minutes", 3}, {"Will be late!", 1},
+		{"How to work next week", 7}};
+	BatchHeap<Message, std::vector<Message>, MessageComparer> message_queue;
+	message_queue.push_range(std::begin(messages), std::end(messages));
+	std::vector<Message> drained;
+	message_queue.pop_n(message_queue.size(), std::back_inserter(drained));
+	for (const auto& message : drained)
+	{
+		std::cout << message.text << " : " << message.rank << "\n";
+	}
+	std::cout << "\n";
+
+	// Ingest and drain a large batch one item at a time, then in bulk
+	int count = argc > 1 ? std::atoi(argv[1]) : 10000000;
+	std::vector<int> batch(count);
+	std::mt19937 generator(3);
+	for (auto& value : batch)
+	{
+		value = generator();
+	}
+	std::vector<int> output(count);
+
+	double single_time = time_msec([&] ()
+		{
+			std::priority_queue<int> single_queue;
+			for (int value : batch)
+			{
+				single_queue.push(value);
+			}
+			for (int i = 0; i < count; i++)
+			{
+				output[i] = single_queue.top();
+				single_queue.pop();
+			}
+		});
+	std::vector<int> expected = output;
+
+	double batch_time = time_msec([&] ()
+		{
+			queue.push_range(std::begin(batch), std::end(batch));
+			queue.pop_n(count, std::begin(output));
+		});
+
+	std::cout << "Ingesting and draining " << count << " integers\n";
+	std::cout << "push/top/pop one at a time: " << single_time << " msec\n";
+	std::cout << "push_range/pop_n:           " << batch_time << " msec\n";
+	std::cout << "Same order: " << std::boolalpha << (output == expected)
+		<< "\n";
+}
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "bucket_queue.h"
+#include "timing.h"
+
+struct Message
+{
+	int rank; // Lower number = Higher Priority
+	std::string text;
+
+	Message(const std::string& text, int rank) : rank(rank), text(text){}
+};
+
+struct Comparer
+{
+	bool operator()(const Message& messageOne, const Message& messageTwo) const
+	{
+		return messageTwo.rank < messageOne.rank;
+	}
+};
+
+/**
+ * Key functions tell the bucket queue which bucket an item belongs to
+ */
+struct RankOf
+{
+	int operator()(const Message& message) const
+	{
+		return message.rank;
+	}
+};
+
+struct ValueOf
+{
+	int operator()(int value) const
+	{
+		return value;
+	}
+};
+
+
+int main(int argc, char* argv[])
+{
+	// Same items as reverse_priority.cpp; 55 is beyond the bucket range
+	BucketQueue<int, ValueOf> numbers(16);
+	numbers.push(3);
+	numbers.push(12);
+	numbers.push(11);
+	numbers.push(55);
+	numbers.push(2);
+	numbers.push(4);
+
+	while (!numbers.empty())
+	{
+		std::cout << numbers.top() << " ";
+		numbers.pop();
+	}
+	std::cout << "\n\n";
+
+	// Same messages as message_priority.cpp, plus two that tie on rank
+	BucketQueue<Message, RankOf> queue(11);
+	queue.push({"Be there soon", 2});
+	queue.push({"Gimme a few minutes", 3});
+	queue.push({"Will be late!", 1});
+	queue.push({"How to work next week", 7});
+	queue.push({"On my way", 2});
+
+	while (!queue.empty())
+	{
+		const Message& message = queue.top();
+		std::cout << message.text << " : " << message.rank << "\n";
+		queue.pop();
+	}
+	std::cout << "\n";
+
+	// Push and drain a large batch of ranks in 0 ... 10 through both queues
+	int count = argc > 1 ? std::atoi(argv[1]) : 10000000;
+
+	long long heap_sum = 0;
+	double heap_time = time_msec([&] ()
+		{
+			std::priority_queue<Message, std::vector<Message>, Comparer> heap;
+			for (int i = 0; i < count; i++)
+			{
+				heap.push({"Dispatch", (i * 7) % 11});
+			}
+			while (!heap.empty())
+			{
+				heap_sum = heap_sum * 3 + heap.top().rank;
+				heap.pop();
+			}
+		});
+
+	long long bucket_sum = 0;
+	double bucket_time = time_msec([&] ()
+		{
+			BucketQueue<Message, RankOf> buckets(11);
+			for (int i = 0; i < count; i++)
+			{
+				buckets.push({"Dispatch", (i * 7) % 11});
+			}
+			while (!buckets.empty())
+			{
+				bucket_sum = bucket_sum * 3 + buckets.top().rank;
+				buckets.pop();
+			}
+		});
+
+	std::cout << "Pushing and popping " << count << " messages\n";
+	std::cout << "std::priority_queue: " << heap_time << " msec\n";
+	std::cout << "BucketQueue:         " << bucket_time << " msec\n";
+	std::cout << "Same order: " << std::boolalpha << (heap_sum == bucket_sum)
+		<< "\n";
+}
@@ -0,0 +1,179 @@
+#ifndef BUCKET_QUEUE_H_
+#define BUCKET_QUEUE_H_
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	When priorities are small integers, a heap is more machinery than the
+ *	job needs. A bucket queue keeps one FIFO bucket per priority in
+ *	[0, range) and a bitmap of the buckets that are not empty:
+ *	- push() appends to the bucket of its key in O(1).
+ *	- top() and pop() use the lowest non-empty bucket, found by scanning
+ *	  the bitmap 64 buckets at a time.
+ *	Items with the same key come out in the order they went in.
+ *
+ *	Lower keys have HIGHER priority, like Message::rank. KeyOf is a function
+ *	object that returns the integer key of an item. Keys outside
+ *	[0, range) still work: they go to an ordinary binary heap that is
+ *	consulted alongside the buckets.
+ *
+ *	The interface is push/top/pop/empty, as for std::priority_queue.
+ */
+template <typename Type, typename KeyOf>
+class BucketQueue
+{
+	struct OverflowItem
+	{
+		long long key;
+		unsigned long long sequence;
+		Type value;
+	};
+
+	// Orders the overflow heap so that its front holds the lowest key, and
+	// the oldest item among equal keys
+	struct OverflowComparer
+	{
+		bool operator()(const OverflowItem& one, const OverflowItem& two) const
+		{
+			return one.key > two.key
+				|| (one.key == two.key && one.sequence > two.sequence);
+		}
+	};
+
+	std::vector<std::deque<Type>> buckets;
+
+	// Bit i of word i / 64 is set when buckets[i] is not empty
+	std::vector<std::uint64_t> occupied;
+
+	// No bucket below this index is occupied
+	std::size_t lowest;
+
+	std::vector<OverflowItem> overflow;
+	unsigned long long next_sequence;
+
+	std::size_t count;
+	KeyOf key_of;
+
+	bool in_range(long long key) const
+	{
+		return key >= 0 && key < static_cast<long long>(buckets.size());
+	}
+
+	/**
+	 * Advances lowest to the first occupied bucket, or buckets.size()
+	 */
+	void find_lowest()
+	{
+		std::size_t word = lowest / 64;
+		if (word >= occupied.size())
+		{
+			lowest = buckets.size();
+			return;
+		}
+
+		std::uint64_t bits = occupied[word] & (~std::uint64_t(0) << (lowest % 64));
+		while (bits == 0)
+		{
+			word++;
+			if (word == occupied.size())
+			{
+				lowest = buckets.size();
+				return;
+			}
+			bits = occupied[word];
+		}
+		lowest = word * 64 + __builtin_ctzll(bits);
+	}
+
+	/**
+	 * True when the best item is in the overflow heap rather than a bucket
+	 */
+	bool overflow_first() const
+	{
+		if (overflow.empty())
+		{
+			return false;
+		}
+		return lowest == buckets.size()
+			|| overflow.front().key < static_cast<long long>(lowest);
+	}
+
+	public:
+	/**
+	 * Keys in [0, range) go to buckets; all others to the fallback heap
+	 */
+	BucketQueue(std::size_t range, const KeyOf& key_of = KeyOf()) :
+		buckets(range), occupied((range + 63) / 64, 0), lowest(range),
+		next_sequence(0), count(0), key_of(key_of) {}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	void push(const Type& value)
+	{
+		push(Type(value));
+	}
+
+	void push(Type&& value)
+	{
+		long long key = key_of(value);
+		if (in_range(key))
+		{
+			std::size_t index = static_cast<std::size_t>(key);
+			buckets[index].push_back(std::move(value));
+			occupied[index / 64] |= std::uint64_t(1) << (index % 64);
+			lowest = std::min(lowest, index);
+		}
+		else
+		{
+			overflow.push_back(OverflowItem {key, next_sequence++,
+					std::move(value)});
+			std::push_heap(overflow.begin(), overflow.end(),
+					OverflowComparer());
+		}
+		count++;
+	}
+
+	const Type& top() const
+	{
+		if (overflow_first())
+		{
+			return overflow.front().value;
+		}
+		return buckets[lowest].front();
+	}
+
+	void pop()
+	{
+		if (overflow_first())
+		{
+			std::pop_heap(overflow.begin(), overflow.end(), OverflowComparer());
+			overflow.pop_back();
+		}
+		else
+		{
+			buckets[lowest].pop_front();
+			if (buckets[lowest].empty())
+			{
+				occupied[lowest / 64] &= ~(std::uint64_t(1) << (lowest % 64));
+				find_lowest();
+			}
+		}
+		count--;
+	}
+};
+
+#endif
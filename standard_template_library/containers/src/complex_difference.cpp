@@ -7,12 +7,14 @@ using Complex = std::complex<double>;
 
 struct ComplexComparer
 {
-	bool operator()(Complex valueOne, Complex valueTwo)
+	bool operator()(const Complex& valueOne, const Complex& valueTwo) const
 	{
 		double a = valueOne.real(), b = valueOne.imag();
 		double c = valueTwo.real(), d = valueTwo.imag();
 
-		return sqrt((a*a + b*b) < (c*c + d*d));
+		// Comparing the squared distances from 0 gives the same order as
+		// comparing the distances, without taking any square roots
+		return (a*a + b*b) < (c*c + d*d);
 	}
 };
 
@@ -0,0 +1,186 @@
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+#include "multi_queue.h"
+#include "timing.h"
+
+struct Message
+{
+	int rank; // Lower number = Higher Priority
+	std::string text;
+
+	Message() : rank(0){}
+	Message(const std::string& text, int rank) : rank(rank), text(text){}
+};
+
+struct Comparer
+{
+	bool operator()(const Message& messageOne, const Message& messageTwo) const
+	{
+		return messageTwo.rank < messageOne.rank;
+	}
+};
+
+
+/**
+ * The baseline: one std::priority_queue behind one lock
+ */
+class LockedQueue
+{
+	std::mutex lock;
+	std::priority_queue<Message, std::vector<Message>, Comparer> queue;
+
+	public:
+	void push(const Message& message)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		queue.push(message);
+	}
+
+	bool try_pop(Message& message)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (queue.empty())
+		{
+			return false;
+		}
+		message = queue.top();
+		queue.pop();
+		return true;
+	}
+};
+
+
+/**
+ * Runs threads producer/consumers against queue, each alternating between
+ * pushing and popping, and returns millions of operations per second
+ */
+template <typename Queue>
+double throughput(Queue& queue, int threads, int operations)
+{
+	// Start from a well filled queue so that pops find work
+	for (int i = 0; i < 100000; i++)
+	{
+		queue.push(Message("Backlog", i % 1000));
+	}
+
+	double msec = time_msec([&] ()
+		{
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; t++)
+			{
+				workers.emplace_back([&queue, operations, t] ()
+					{
+						std::minstd_rand generator(t + 1);
+						Message message;
+						for (int i = 0; i < operations / 2; i++)
+						{
+							queue.push(Message("Dispatch", generator() % 1000));
+							queue.try_pop(message);
+						}
+					});
+			}
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+		});
+	return threads * (operations / 2) * 2 / msec / 1e3;
+}
+
+
+/**
+ * Pushes count messages with distinct ranks, pops them all and measures how
+ * many better messages were still waiting each time (the rank error)
+ */
+template <typename Queue>
+void rank_error(Queue& queue, int count, double& mean, int& worst)
+{
+	std::vector<int> ranks(count);
+	for (int i = 0; i < count; i++)
+	{
+		ranks[i] = i;
+	}
+	std::shuffle(ranks.begin(), ranks.end(), std::minstd_rand(7));
+	for (int rank : ranks)
+	{
+		queue.push(Message("Ranked", rank));
+	}
+
+	// Fenwick tree over ranks still in the queue
+	std::vector<int> tree(count + 1, 0);
+	auto add = [&tree, count] (int index, int delta)
+	{
+		for (index++; index <= count; index += index & -index)
+		{
+			tree[index] += delta;
+		}
+	};
+	auto below = [&tree] (int index)
+	{
+		int total = 0;
+		for (; index > 0; index -= index & -index)
+		{
+			total += tree[index];
+		}
+		return total;
+	};
+	for (int i = 0; i < count; i++)
+	{
+		add(i, 1);
+	}
+
+	long long total = 0;
+	worst = 0;
+	Message message;
+	while (queue.try_pop(message))
+	{
+		int error = below(message.rank);
+		total += error;
+		worst = std::max(worst, error);
+		add(message.rank, -1);
+	}
+	mean = static_cast<double>(total) / count;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int max_threads = argc > 1 ? std::atoi(argv[1])
+		: std::max(4u, std::thread::hardware_concurrency());
+	int operations = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+	std::cout << "Throughput (million operations per second)\n";
+	std::cout << "threads    locked std::priority_queue    strict    relaxed\n";
+	for (int threads = 1; threads <= max_threads; threads *= 2)
+	{
+		LockedQueue locked;
+		MultiQueue<Message, Comparer> strict(threads, 2, true);
+		MultiQueue<Message, Comparer> relaxed(threads);
+
+		std::cout << threads << "          "
+			<< throughput(locked, threads, operations) << "                       "
+			<< throughput(strict, threads, operations) << "    "
+			<< throughput(relaxed, threads, operations) << "\n";
+	}
+	std::cout << "\n";
+
+	double mean;
+	int worst;
+	MultiQueue<Message, Comparer> strict(max_threads, 2, true);
+	rank_error(strict, 100000, mean, worst);
+	std::cout << "Rank error, strict:  mean " << mean << ", worst " << worst
+		<< "\n";
+
+	MultiQueue<Message, Comparer> relaxed(max_threads);
+	rank_error(relaxed, 100000, mean, worst);
+	std::cout << "Rank error, relaxed (" << max_threads * 2 << " heaps): mean "
+		<< mean << ", worst " << worst << "\n";
+}
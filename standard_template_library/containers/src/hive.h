@@ -0,0 +1,461 @@
+#ifndef HIVE_H_
+#define HIVE_H_
+
+#include <iterator>
+#include <new>
+#include <initializer_list>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * NOTE:
+ *	std::list allocates every element on its own, so walking it jumps
+ *	around the heap and usually misses the cache on every element. A Hive
+ *	(also known as a colony) stores elements in blocks of consecutive slots
+ *	instead, while still never moving an element once it is inserted:
+ *	pointers and iterators to an element stay valid until that element is
+ *	erased, as with std::list.
+ *
+ *	Erasing an element leaves a hole in its block. Each block keeps a skip
+ *	field, one counter per slot: for a run of holes, the first and last
+ *	slots hold the length of the run, and live slots hold 0. Stepping an
+ *	iterator is then index++ followed by index += skip[index], which jumps
+ *	over a whole run of holes at once, with no branch per hole.
+ *
+ *	The holes are reused by later insertions, so insert and erase are both
+ *	O(1). Each block keeps a list of its runs of holes, linked through the
+ *	empty slots themselves, and the Hive keeps a list of the blocks that
+ *	have holes. A block whose last element is erased is freed.
+ *
+ *	Elements are visited block by block, in slot order. That is the order
+ *	of insertion until something is erased; after that, new elements fill
+ *	the holes first, so a Hive suits collections whose order does not
+ *	matter. Blocks start with 8 slots and double in size up to
+ *	MaxBlockSize.
+ */
+template <typename Type, std::size_t MaxBlockSize = 8192>
+class Hive
+{
+	static_assert(MaxBlockSize >= 8 && MaxBlockSize < 65535,
+			"Hive block sizes must fit the 16 bit skip field");
+
+	using Index = std::uint16_t;
+	static constexpr Index NONE = 65535;
+
+	// A hole that starts a run links to the other runs of its block
+	struct RunLinks
+	{
+		Index previous;
+		Index next;
+	};
+
+	union Slot
+	{
+		Type value;
+		RunLinks links;
+
+		Slot() {}
+		~Slot() {}
+	};
+
+	struct Block
+	{
+		Slot* slots;
+		Index* skip;
+		Index capacity;
+		Index high = 0;
+		Index live = 0;
+		Index first_run = NONE;
+		Block* previous = nullptr;
+		Block* next = nullptr;
+		Block* previous_with_holes = nullptr;
+		Block* next_with_holes = nullptr;
+
+		explicit Block(Index capacity) :
+			slots(new Slot[capacity]),
+			// One extra counter past the end, always 0, stops iteration
+			skip(new Index[capacity + 1]()),
+			capacity(capacity) {}
+
+		~Block()
+		{
+			delete[] slots;
+			delete[] skip;
+		}
+	};
+
+	Block* head;
+	Block* tail;
+	Block* with_holes;
+	std::size_t count;
+
+	template <typename Value, typename Owner>
+	class Iterator
+	{
+		friend class Hive;
+
+		Owner* block;
+		Index index;
+
+		Iterator(Owner* block, Index index) : block(block), index(index) {}
+
+		public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		Iterator() : block(nullptr), index(0) {}
+
+		// An iterator converts to a const_iterator
+		template <typename OtherValue, typename OtherOwner>
+		Iterator(const Iterator<OtherValue, OtherOwner>& other) :
+			block(other.block), index(other.index) {}
+
+		Value& operator*() const
+		{
+			return block->slots[index].value;
+		}
+
+		Value* operator->() const
+		{
+			return &block->slots[index].value;
+		}
+
+		Iterator& operator++()
+		{
+			index++;
+			index += block->skip[index];
+			if (index == block->high)
+			{
+				block = block->next;
+				index = block ? block->skip[0] : 0;
+			}
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator old = *this;
+			++*this;
+			return old;
+		}
+
+		bool operator==(const Iterator& other) const
+		{
+			return block == other.block && index == other.index;
+		}
+
+		bool operator!=(const Iterator& other) const
+		{
+			return !(*this == other);
+		}
+
+		template <typename, typename>
+		friend class Iterator;
+	};
+
+	void link_holes(Block* block)
+	{
+		block->previous_with_holes = nullptr;
+		block->next_with_holes = with_holes;
+		if (with_holes)
+		{
+			with_holes->previous_with_holes = block;
+		}
+		with_holes = block;
+	}
+
+	void unlink_holes(Block* block)
+	{
+		if (block->previous_with_holes)
+		{
+			block->previous_with_holes->next_with_holes = block->next_with_holes;
+		}
+		else
+		{
+			with_holes = block->next_with_holes;
+		}
+		if (block->next_with_holes)
+		{
+			block->next_with_holes->previous_with_holes = block->previous_with_holes;
+		}
+		block->previous_with_holes = block->next_with_holes = nullptr;
+	}
+
+	static void push_run(Block* block, Index start)
+	{
+		block->slots[start].links = {NONE, block->first_run};
+		if (block->first_run != NONE)
+		{
+			block->slots[block->first_run].links.previous = start;
+		}
+		block->first_run = start;
+	}
+
+	static void remove_run(Block* block, Index start)
+	{
+		RunLinks links = block->slots[start].links;
+		if (links.previous != NONE)
+		{
+			block->slots[links.previous].links.next = links.next;
+		}
+		else
+		{
+			block->first_run = links.next;
+		}
+		if (links.next != NONE)
+		{
+			block->slots[links.next].links.previous = links.previous;
+		}
+	}
+
+	// The run starting at from now starts at to
+	static void move_run(Block* block, Index from, Index to)
+	{
+		RunLinks links = block->slots[from].links;
+		block->slots[to].links = links;
+		if (links.previous != NONE)
+		{
+			block->slots[links.previous].links.next = to;
+		}
+		else
+		{
+			block->first_run = to;
+		}
+		if (links.next != NONE)
+		{
+			block->slots[links.next].links.previous = to;
+		}
+	}
+
+	/**
+	 * A slot to construct the next element in: the first hole of some
+	 * run, or else the next unused slot of the last block
+	 */
+	std::pair<Block*, Index> take_slot()
+	{
+		if (with_holes)
+		{
+			Block* block = with_holes;
+			Index start = block->first_run;
+			Index length = block->skip[start];
+			remove_run(block, start);
+			if (length > 1)
+			{
+				Index rest = start + 1;
+				block->skip[rest] = length - 1;
+				block->skip[start + length - 1] = length - 1;
+				push_run(block, rest);
+			}
+			block->skip[start] = 0;
+			if (block->first_run == NONE)
+			{
+				unlink_holes(block);
+			}
+			return {block, start};
+		}
+
+		if (!tail || tail->high == tail->capacity)
+		{
+			std::size_t size = tail ? 2 * std::size_t(tail->capacity) : 8;
+			Block* block = new Block(static_cast<Index>(
+						size < MaxBlockSize ? size : MaxBlockSize));
+			block->previous = tail;
+			if (tail)
+			{
+				tail->next = block;
+			}
+			else
+			{
+				head = block;
+			}
+			tail = block;
+		}
+		return {tail, tail->high++};
+	}
+
+	void free_block(Block* block)
+	{
+		if (block->first_run != NONE)
+		{
+			unlink_holes(block);
+		}
+		if (block->previous)
+		{
+			block->previous->next = block->next;
+		}
+		else
+		{
+			head = block->next;
+		}
+		if (block->next)
+		{
+			block->next->previous = block->previous;
+		}
+		else
+		{
+			tail = block->previous;
+		}
+		delete block;
+	}
+
+	public:
+	using value_type = Type;
+	using iterator = Iterator<Type, Block>;
+	using const_iterator = Iterator<const Type, const Block>;
+
+	Hive() : head(nullptr), tail(nullptr), with_holes(nullptr), count(0) {}
+
+	Hive(std::initializer_list<Type> items) : Hive()
+	{
+		for (const Type& item : items)
+		{
+			insert(item);
+		}
+	}
+
+	Hive(const Hive&) = delete;
+	Hive& operator=(const Hive&) = delete;
+
+	Hive(Hive&& other) :
+		head(other.head), tail(other.tail), with_holes(other.with_holes),
+		count(other.count)
+	{
+		other.head = other.tail = other.with_holes = nullptr;
+		other.count = 0;
+	}
+
+	~Hive()
+	{
+		clear();
+	}
+
+	template <typename... Args>
+	iterator emplace(Args&&... args)
+	{
+		auto [block, index] = take_slot();
+		::new (static_cast<void*>(&block->slots[index].value))
+			Type(std::forward<Args>(args)...);
+		block->live++;
+		count++;
+		return iterator(block, index);
+	}
+
+	iterator insert(const Type& item)
+	{
+		return emplace(item);
+	}
+
+	iterator insert(Type&& item)
+	{
+		return emplace(std::move(item));
+	}
+
+	/**
+	 * Erases the element at position and returns the one after it
+	 */
+	iterator erase(const_iterator position)
+	{
+		Block* block = const_cast<Block*>(position.block);
+		Index index = position.index;
+		iterator after(block, index);
+		++after;
+
+		block->slots[index].value.~Type();
+		count--;
+		if (--block->live == 0)
+		{
+			free_block(block);
+			return after;
+		}
+
+		Index left = index > 0 ? block->skip[index - 1] : 0;
+		Index right = index + 1 < block->high ? block->skip[index + 1] : 0;
+		bool had_holes = block->first_run != NONE;
+		if (left && right)
+		{
+			// Join the runs on both sides into one
+			Index start = index - left;
+			Index length = left + 1 + right;
+			remove_run(block, index + 1);
+			block->skip[start] = length;
+			block->skip[index + right] = length;
+			block->skip[index] = 1;
+		}
+		else if (left)
+		{
+			Index start = index - left;
+			block->skip[start] = left + 1;
+			block->skip[index] = left + 1;
+		}
+		else if (right)
+		{
+			move_run(block, index + 1, index);
+			block->skip[index] = right + 1;
+			block->skip[index + right] = right + 1;
+		}
+		else
+		{
+			block->skip[index] = 1;
+			push_run(block, index);
+		}
+		if (!had_holes)
+		{
+			link_holes(block);
+		}
+		return after;
+	}
+
+	void clear()
+	{
+		for (Block* block = head; block; )
+		{
+			Block* next = block->next;
+			for (Index i = block->skip[0]; i < block->high; )
+			{
+				block->slots[i].value.~Type();
+				i++;
+				i += block->skip[i];
+			}
+			delete block;
+			block = next;
+		}
+		head = tail = with_holes = nullptr;
+		count = 0;
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+
+	iterator begin()
+	{
+		return head ? iterator(head, head->skip[0]) : iterator();
+	}
+
+	iterator end()
+	{
+		return iterator();
+	}
+
+	const_iterator begin() const
+	{
+		return head ? const_iterator(head, head->skip[0]) : const_iterator();
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator();
+	}
+};
+
+#endif
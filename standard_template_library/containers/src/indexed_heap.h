@@ -0,0 +1,285 @@
+#ifndef INDEXED_HEAP_H_
+#define INDEXED_HEAP_H_
+
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	A priority queue with the same ordering convention as
+ *	std::priority_queue: compare(a, b) returns true when a has LOWER
+ *	priority than b, so top() is the element that compares greatest.
+ *
+ *	Differences from std::priority_queue:
+ *	- The heap is Arity-ary (4 by default). A wider node means a shallower
+ *	  tree, and the children of a node sit next to each other in memory.
+ *	- pop() moves the top element out instead of forcing a copy of top().
+ *	- push() and emplace() return a Handle that stays valid until the
+ *	  element leaves the queue. update_priority() and erase() use it to
+ *	  find the element in O(1) and restore heap order in O(log n).
+ *	  Handles are recycled, but each carries a generation, so a handle to
+ *	  an element that has left fails contains() rather than naming a newer
+ *	  element.
+ */
+template <typename Type, typename Compare, int Arity = 4>
+class IndexedHeap
+{
+	public:
+	struct Handle
+	{
+		std::size_t entry;
+		std::size_t generation;
+	};
+
+	private:
+	struct Slot
+	{
+		Type value;
+		std::size_t entry;
+	};
+
+	// Where one handle's element sits in the heap, and how many times the
+	// entry has been given out before
+	struct Entry
+	{
+		std::size_t position;
+		std::size_t generation;
+	};
+
+	// The heap itself; each element remembers its own entry
+	std::vector<Slot> heap;
+
+	std::vector<Entry> entries;
+
+	// Entries of elements that have left the queue, ready for reuse
+	std::vector<std::size_t> free_entries;
+
+	Compare compare;
+
+	static constexpr std::size_t NOT_PRESENT = static_cast<std::size_t>(-1);
+
+	void place(std::size_t index, Slot&& slot)
+	{
+		entries[slot.entry].position = index;
+		heap[index] = std::move(slot);
+	}
+
+	/**
+	 * Moves the element at index towards the root until its parent has no
+	 * lower priority
+	 */
+	void sift_up(std::size_t index)
+	{
+		Slot moving = std::move(heap[index]);
+		while (index > 0)
+		{
+			std::size_t parent = (index - 1) / Arity;
+			if (!compare(heap[parent].value, moving.value))
+			{
+				break;
+			}
+			place(index, std::move(heap[parent]));
+			index = parent;
+		}
+		place(index, std::move(moving));
+	}
+
+	/**
+	 * Moves the element at index towards the leaves until none of its
+	 * children has higher priority
+	 */
+	void sift_down(std::size_t index)
+	{
+		std::size_t size = heap.size();
+		Slot moving = std::move(heap[index]);
+		while (true)
+		{
+			std::size_t first = index * Arity + 1;
+			if (first >= size)
+			{
+				break;
+			}
+
+			// Find the child with the highest priority
+			std::size_t last = first + Arity < size ? first + Arity : size;
+			std::size_t best = first;
+			for (std::size_t child = first + 1; child < last; child++)
+			{
+				if (compare(heap[best].value, heap[child].value))
+				{
+					best = child;
+				}
+			}
+
+			if (!compare(moving.value, heap[best].value))
+			{
+				break;
+			}
+			place(index, std::move(heap[best]));
+			index = best;
+		}
+		place(index, std::move(moving));
+	}
+
+	/**
+	 * Restores heap order around index after its element changed
+	 */
+	void fix(std::size_t index)
+	{
+		if (index > 0 && compare(heap[(index - 1) / Arity].value,
+					heap[index].value))
+		{
+			sift_up(index);
+		}
+		else
+		{
+			sift_down(index);
+		}
+	}
+
+	Handle acquire_handle()
+	{
+		if (!free_entries.empty())
+		{
+			std::size_t entry = free_entries.back();
+			free_entries.pop_back();
+			return Handle {entry, entries[entry].generation};
+		}
+		entries.push_back(Entry {NOT_PRESENT, 0});
+		return Handle {entries.size() - 1, 0};
+	}
+
+	/**
+	 * Takes the element at index out of the heap and fills the gap with the
+	 * last element
+	 */
+	Type remove_at(std::size_t index)
+	{
+		std::size_t entry = heap[index].entry;
+		Type value = std::move(heap[index].value);
+		entries[entry].position = NOT_PRESENT;
+		entries[entry].generation++;
+		free_entries.push_back(entry);
+
+		Slot last = std::move(heap.back());
+		heap.pop_back();
+		if (index < heap.size())
+		{
+			place(index, std::move(last));
+			fix(index);
+		}
+		return value;
+	}
+
+	public:
+	IndexedHeap(const Compare& compare = Compare()) : compare(compare) {}
+
+	bool empty() const
+	{
+		return heap.empty();
+	}
+
+	std::size_t size() const
+	{
+		return heap.size();
+	}
+
+	void reserve(std::size_t capacity)
+	{
+		heap.reserve(capacity);
+		entries.reserve(capacity);
+	}
+
+	const Type& top() const
+	{
+		return heap.front().value;
+	}
+
+	/**
+	 * Constructs the element in place from args and returns its handle
+	 */
+	template <typename... Args>
+	Handle emplace(Args&&... args)
+	{
+		Handle handle = acquire_handle();
+		heap.push_back(Slot {Type(std::forward<Args>(args)...),
+				handle.entry});
+		entries[handle.entry].position = heap.size() - 1;
+		sift_up(heap.size() - 1);
+		return handle;
+	}
+
+	Handle push(const Type& value)
+	{
+		return emplace(value);
+	}
+
+	Handle push(Type&& value)
+	{
+		return emplace(std::move(value));
+	}
+
+	/**
+	 * Removes the top element and hands it back by move
+	 */
+	Type pop()
+	{
+		return remove_at(0);
+	}
+
+	/**
+	 * Whether the element behind handle is still in the queue
+	 */
+	bool contains(Handle handle) const
+	{
+		return handle.entry < entries.size()
+			&& entries[handle.entry].generation == handle.generation
+			&& entries[handle.entry].position != NOT_PRESENT;
+	}
+
+	const Type& get(Handle handle) const
+	{
+		assert(contains(handle));
+		return heap[entries[handle.entry].position].value;
+	}
+
+	/**
+	 * Lets modify change the element behind handle, for example its rank,
+	 * then moves it up or down to its new place
+	 */
+	template <typename Modifier>
+	void update_priority(Handle handle, Modifier modify)
+	{
+		assert(contains(handle));
+		std::size_t index = entries[handle.entry].position;
+		modify(heap[index].value);
+		fix(index);
+	}
+
+	/**
+	 * Removes the element behind handle, wherever it is in the heap
+	 */
+	Type erase(Handle handle)
+	{
+		assert(contains(handle));
+		return remove_at(entries[handle.entry].position);
+	}
+
+	/**
+	 * Empties the queue; handles given out before stay stale for good
+	 */
+	void clear()
+	{
+		for (const Slot& slot : heap)
+		{
+			entries[slot.entry].position = NOT_PRESENT;
+			entries[slot.entry].generation++;
+			free_entries.push_back(slot.entry);
+		}
+		heap.clear();
+	}
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "indexed_heap.h"
+#include "timing.h"
+
+struct Message
+{
+	int rank; // Lower number = Higher Priority
+	std::string text;
+
+	Message(const std::string& text, int rank) : rank(rank), text(text){}
+};
+
+/**
+ * The original comparer, which takes both messages by value
+ */
+struct CopyingComparer
+{
+	bool operator()(Message messageOne, Message messageTwo)
+	{
+		return messageTwo.rank < messageOne.rank;
+	}
+};
+
+struct Comparer
+{
+	bool operator()(const Message& messageOne, const Message& messageTwo) const
+	{
+		return messageTwo.rank < messageOne.rank;
+	}
+};
+
+using MessageQueue = IndexedHeap<Message, Comparer>;
+
+
+int main(int argc, char* argv[])
+{
+	MessageQueue queue;
+
+	queue.emplace("Be there soon", 2);
+	queue.emplace("Gimme a few minutes", 3);
+	MessageQueue::Handle late = queue.emplace("Will be late!", 1);
+	MessageQueue::Handle week = queue.emplace("How to work next week", 7);
+	MessageQueue::Handle spam = queue.emplace("You have won a prize", 5);
+
+	// The plans for next week just became urgent, and the spam goes away
+	queue.update_priority(week, [] (Message& message) { message.rank = 0; });
+	queue.erase(spam);
+	std::cout << "Still queued: " << queue.get(late).text << "\n\n";
+
+	while (!queue.empty())
+	{
+		Message message = queue.pop();
+		std::cout << message.text << " : " << message.rank << "\n";
+	}
+	std::cout << "\n";
+
+	// Push and drain a large batch through both queues
+	int count = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	std::vector<Message> messages;
+	messages.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		messages.emplace_back("Dispatch tier message number "
+				+ std::to_string(i), (i * 7919) % 1000);
+	}
+
+	long long standard_checksum = 0;
+	double standard_time = time_msec([&] ()
+		{
+			std::priority_queue<Message, std::vector<Message>, CopyingComparer>
+				standard_queue;
+			for (const auto& message : messages)
+			{
+				standard_queue.push(message);
+			}
+			while (!standard_queue.empty())
+			{
+				Message message = standard_queue.top();
+				standard_checksum = standard_checksum * 31 + message.rank;
+				standard_queue.pop();
+			}
+		});
+
+	long long indexed_checksum = 0;
+	double indexed_time = time_msec([&] ()
+		{
+			queue.reserve(count);
+			for (auto& message : messages)
+			{
+				queue.push(std::move(message));
+			}
+			while (!queue.empty())
+			{
+				Message message = queue.pop();
+				indexed_checksum = indexed_checksum * 31 + message.rank;
+			}
+		});
+
+	std::cout << "Pushing and popping " << count << " messages\n";
+	std::cout << "std::priority_queue, by value comparer: " << standard_time
+		<< " msec\n";
+	std::cout << "IndexedHeap, 4-ary, by reference:       " << indexed_time
+		<< " msec\n";
+	std::cout << "Same order: " << std::boolalpha
+		<< (standard_checksum == indexed_checksum) << "\n";
+}
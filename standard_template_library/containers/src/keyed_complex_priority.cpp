@@ -0,0 +1,134 @@
+#include <iostream>
+#include <queue>
+#include <complex>
+#include <vector>
+#include <random>
+#include <cstdlib>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "keyed_heap.h"
+#include "timing.h"
+
+using Complex = std::complex<double>;
+
+
+struct ComplexComparer
+{
+	bool operator()(const Complex& valueOne, const Complex& valueTwo) const
+	{
+		double a = valueOne.real(), b = valueOne.imag();
+		double c = valueTwo.real(), d = valueTwo.imag();
+
+		return (a*a + b*b) < (c*c + d*d);
+	}
+};
+
+
+/**
+ * The key of a complex number is its squared distance from 0
+ */
+struct SquaredMagnitude
+{
+	double operator()(const Complex& value) const
+	{
+		return value.real() * value.real() + value.imag() * value.imag();
+	}
+};
+
+
+/**
+ * Computes the squared magnitudes of a batch of complex numbers. When built
+ * with AVX2 (for example -mavx2 or -march=native) four are done at a time.
+ */
+void compute_keys(const SquaredMagnitude& key_of, const Complex* values,
+		std::size_t count, double* keys)
+{
+	std::size_t i = 0;
+#ifdef __AVX2__
+	// std::complex<double> is laid out as { real, imag }
+	const double* parts = reinterpret_cast<const double*>(values);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d one = _mm256_loadu_pd(parts + 2 * i);
+		__m256d two = _mm256_loadu_pd(parts + 2 * i + 4);
+		one = _mm256_mul_pd(one, one);
+		two = _mm256_mul_pd(two, two);
+
+		// hadd gives the keys in the order 0, 2, 1, 3
+		__m256d sums = _mm256_hadd_pd(one, two);
+		_mm256_storeu_pd(keys + i, _mm256_permute4x64_pd(sums, 0xD8));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		keys[i] = key_of(values[i]);
+	}
+}
+
+
+int main(int argc, char* argv[])
+{
+	KeyedHeap<Complex, SquaredMagnitude> queue;
+
+	queue.push({3, 2});
+	queue.push({12, 3});
+	queue.push({11, 5});
+	queue.push({5, 45});
+	queue.push({2, 1});
+	queue.push({2.4, 5.4});
+
+	while (!queue.empty())
+	{
+		std::cout << queue.top() << " ";
+		queue.pop();
+	}
+	std::cout << "\n";
+
+	// Push and drain a large batch through both queues
+	int count = argc > 1 ? std::atoi(argv[1]) : 5000000;
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<double> part(-100.0, 100.0);
+	std::vector<Complex> values(count);
+	for (auto& value : values)
+	{
+		value = Complex(part(generator), part(generator));
+	}
+
+	double standard_sum = 0;
+	double standard_time = time_msec([&] ()
+		{
+			std::priority_queue<Complex, std::vector<Complex>, ComplexComparer>
+				standard_queue;
+			for (const auto& value : values)
+			{
+				standard_queue.push(value);
+			}
+			while (!standard_queue.empty())
+			{
+				standard_sum += std::norm(standard_queue.top());
+				standard_queue.pop();
+			}
+		});
+
+	double keyed_sum = 0;
+	double keyed_time = time_msec([&] ()
+		{
+			queue.push_batch(values.data(), values.data() + values.size());
+			while (!queue.empty())
+			{
+				keyed_sum += queue.top_key();
+				queue.pop();
+			}
+		});
+
+	std::cout << "Pushing and popping " << count << " complex numbers\n";
+	std::cout << "std::priority_queue with ComplexComparer: " << standard_time
+		<< " msec\n";
+	std::cout << "KeyedHeap with push_batch:                " << keyed_time
+		<< " msec\n";
+	std::cout << "Same total: " << std::boolalpha
+		<< (standard_sum == keyed_sum) << "\n";
+}
@@ -0,0 +1,210 @@
+#ifndef KEYED_HEAP_H_
+#define KEYED_HEAP_H_
+
+#include <vector>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	A comparer such as ComplexComparer recomputes the priority of both
+ *	items on every comparison. KeyedHeap computes the key of an item once,
+ *	when it is pushed, and stores keys and items in separate arrays
+ *	(structure of arrays):
+ *	- keys[]   the dense array of keys, in heap order
+ *	- slots[]  for each heap position, where the item lives in values[]
+ *	- values[] the items themselves, which never move once pushed
+ *	Sifting compares and moves only keys and slot numbers, however large
+ *	the items are.
+ *
+ *	Ordering follows std::priority_queue: Compare(a, b) is true when key a
+ *	has LOWER priority, so with std::less the largest key is on top.
+ */
+template <typename Key, typename Type, typename KeyOf>
+void compute_keys(const KeyOf& key_of, const Type* values, std::size_t count,
+		Key* keys)
+{
+	// A plain loop with no dependencies between iterations, which the
+	// compiler is free to vectorise. Key functions can provide their own
+	// overload of compute_keys with an explicit SIMD kernel.
+	for (std::size_t i = 0; i < count; i++)
+	{
+		keys[i] = key_of(values[i]);
+	}
+}
+
+
+template <typename Type, typename KeyOf, typename Key = double,
+		 typename Compare = std::less<Key>>
+class KeyedHeap
+{
+	std::vector<Key> keys;
+	std::vector<std::uint32_t> slots;
+	std::vector<Type> values;
+
+	// Entries of values[] whose items have been popped; the old item stays
+	// there until the slot is reused
+	std::vector<std::uint32_t> free_slots;
+
+	KeyOf key_of;
+	Compare compare;
+
+	void sift_up(std::size_t index)
+	{
+		Key key = keys[index];
+		std::uint32_t slot = slots[index];
+		while (index > 0)
+		{
+			std::size_t parent = (index - 1) / 2;
+			if (!compare(keys[parent], key))
+			{
+				break;
+			}
+			keys[index] = keys[parent];
+			slots[index] = slots[parent];
+			index = parent;
+		}
+		keys[index] = key;
+		slots[index] = slot;
+	}
+
+	void sift_down(std::size_t index)
+	{
+		std::size_t size = keys.size();
+		Key key = keys[index];
+		std::uint32_t slot = slots[index];
+		while (true)
+		{
+			std::size_t child = 2 * index + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && compare(keys[child], keys[child + 1]))
+			{
+				child++;
+			}
+			if (!compare(key, keys[child]))
+			{
+				break;
+			}
+			keys[index] = keys[child];
+			slots[index] = slots[child];
+			index = child;
+		}
+		keys[index] = key;
+		slots[index] = slot;
+	}
+
+	std::uint32_t store(Type&& value)
+	{
+		if (!free_slots.empty())
+		{
+			std::uint32_t slot = free_slots.back();
+			free_slots.pop_back();
+			values[slot] = std::move(value);
+			return slot;
+		}
+		values.push_back(std::move(value));
+		return static_cast<std::uint32_t>(values.size() - 1);
+	}
+
+	public:
+	KeyedHeap(const KeyOf& key_of = KeyOf(), const Compare& compare = Compare())
+		: key_of(key_of), compare(compare) {}
+
+	bool empty() const
+	{
+		return keys.empty();
+	}
+
+	std::size_t size() const
+	{
+		return keys.size();
+	}
+
+	void reserve(std::size_t capacity)
+	{
+		keys.reserve(capacity);
+		slots.reserve(capacity);
+		values.reserve(capacity);
+	}
+
+	const Type& top() const
+	{
+		return values[slots.front()];
+	}
+
+	const Key& top_key() const
+	{
+		return keys.front();
+	}
+
+	void push(const Type& value)
+	{
+		push(Type(value));
+	}
+
+	void push(Type&& value)
+	{
+		keys.push_back(key_of(value));
+		slots.push_back(store(std::move(value)));
+		sift_up(keys.size() - 1);
+	}
+
+	/**
+	 * Pushes the items in [first, last). All their keys are computed in one
+	 * batch, and a batch at least as large as the heap is heapified in O(n)
+	 * rather than sifted in one item at a time.
+	 */
+	void push_batch(const Type* first, const Type* last)
+	{
+		std::size_t old_size = keys.size();
+		std::size_t count = last - first;
+		keys.resize(old_size + count);
+		compute_keys(key_of, first, count, keys.data() + old_size);
+
+		slots.reserve(old_size + count);
+		for (const Type* value = first; value != last; value++)
+		{
+			slots.push_back(store(Type(*value)));
+		}
+
+		if (count >= old_size)
+		{
+			for (std::size_t index = keys.size() / 2; index-- > 0; )
+			{
+				sift_down(index);
+			}
+		}
+		else
+		{
+			for (std::size_t index = old_size; index < keys.size(); index++)
+			{
+				sift_up(index);
+			}
+		}
+	}
+
+	void pop()
+	{
+		free_slots.push_back(slots.front());
+		keys.front() = keys.back();
+		slots.front() = slots.back();
+		keys.pop_back();
+		slots.pop_back();
+		if (!keys.empty())
+		{
+			sift_down(0);
+		}
+		else
+		{
+			values.clear();
+			free_slots.clear();
+		}
+	}
+};
+
+#endif
@@ -7,12 +7,14 @@ struct Message
 	int rank; // Lower number = Higher Priority
 	std::string text;
 
-	Message(const std::string& text, int rank) : text(text), rank(rank){}
+	Message(const std::string& text, int rank) : rank(rank), text(text){}
 };
 
 struct Comparer
 {
-	bool operator()(Message messageOne, Message messageTwo)
+	// Take the messages by reference; by value every comparison would copy
+	// both strings
+	bool operator()(const Message& messageOne, const Message& messageTwo) const
 	{
 		return messageTwo.rank < messageOne.rank;
 	}
@@ -29,7 +31,7 @@ int main()
 
 	while (!queue.empty())
 	{
-		Message message = queue.top();
+		const Message& message = queue.top();
 		std::cout << message.text << " : " << message.rank << "\n";
 		queue.pop();
 	}
@@ -0,0 +1,187 @@
+#ifndef MULTI_QUEUE_H_
+#define MULTI_QUEUE_H_
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+
+/**
+ * NOTE:
+ *	A concurrent priority queue for many producers and consumers. A single
+ *	heap behind a single lock makes every thread wait for every other one,
+ *	so instead the MultiQueue keeps several independent heaps, each with
+ *	its own lock:
+ *	- push() puts the item in a randomly chosen heap.
+ *	- pop() looks at the tops of two randomly chosen heaps and takes the
+ *	  better one ("power of two choices").
+ *	The item popped is not always the very best one in the whole queue, but
+ *	its rank error stays small on average, and threads rarely contend.
+ *
+ *	With strict = true there is only one heap, which gives exact ordering
+ *	and the same behaviour as a locked std::priority_queue, for comparison.
+ *
+ *	Compare follows the std::priority_queue convention: compare(a, b) is
+ *	true when a has LOWER priority than b.
+ */
+template <typename Type, typename Compare>
+class MultiQueue
+{
+	// Each heap lives on its own cache line so that threads working on
+	// neighbouring heaps do not slow each other down
+	struct alignas(64) SubQueue
+	{
+		std::mutex lock;
+		std::vector<Type> heap;
+	};
+
+	std::unique_ptr<SubQueue[]> queues;
+	int queue_count;
+	Compare compare;
+
+	// Number of items across all heaps; lets pop() tell an empty queue from
+	// two unlucky picks
+	std::atomic<long long> item_count;
+
+	int random_queue()
+	{
+		thread_local std::minstd_rand generator(static_cast<unsigned>(
+					std::hash<std::thread::id>()(std::this_thread::get_id())));
+		return std::uniform_int_distribution<int>(0, queue_count - 1)(
+				generator);
+	}
+
+	/**
+	 * Pops the top of queue into value; the caller holds its lock
+	 */
+	void take(SubQueue& queue, Type& value)
+	{
+		std::pop_heap(queue.heap.begin(), queue.heap.end(), compare);
+		value = std::move(queue.heap.back());
+		queue.heap.pop_back();
+		item_count--;
+	}
+
+	public:
+	/**
+	 * Uses queues_per_thread heaps for every thread expected to share the
+	 * queue, or a single heap in strict mode
+	 */
+	MultiQueue(int threads, int queues_per_thread = 2, bool strict = false,
+			const Compare& compare = Compare()) :
+		queue_count(strict ? 1 : std::max(1, threads * queues_per_thread)),
+		compare(compare), item_count(0)
+	{
+		queues.reset(new SubQueue[queue_count]);
+	}
+
+	void push(const Type& value)
+	{
+		push(Type(value));
+	}
+
+	void push(Type&& value)
+	{
+		if (queue_count == 1)
+		{
+			std::lock_guard<std::mutex> guard(queues[0].lock);
+			queues[0].heap.push_back(std::move(value));
+			std::push_heap(queues[0].heap.begin(), queues[0].heap.end(),
+					compare);
+			item_count++;
+			return;
+		}
+
+		while (true)
+		{
+			SubQueue& queue = queues[random_queue()];
+			if (queue.lock.try_lock())
+			{
+				queue.heap.push_back(std::move(value));
+				std::push_heap(queue.heap.begin(), queue.heap.end(), compare);
+				item_count++;
+				queue.lock.unlock();
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Moves a high priority item into value. Returns false only if the
+	 * queue was empty.
+	 */
+	bool try_pop(Type& value)
+	{
+		if (queue_count == 1)
+		{
+			std::lock_guard<std::mutex> guard(queues[0].lock);
+			if (queues[0].heap.empty())
+			{
+				return false;
+			}
+			take(queues[0], value);
+			return true;
+		}
+
+		while (item_count.load() > 0)
+		{
+			int first = random_queue(), second = random_queue();
+			if (first == second)
+			{
+				continue;
+			}
+
+			// Always lock in index order so two threads cannot deadlock
+			SubQueue& one = queues[std::min(first, second)];
+			SubQueue& two = queues[std::max(first, second)];
+			if (!one.lock.try_lock())
+			{
+				continue;
+			}
+			if (!two.lock.try_lock())
+			{
+				one.lock.unlock();
+				continue;
+			}
+
+			SubQueue* best = nullptr;
+			if (!one.heap.empty())
+			{
+				best = &one;
+			}
+			if (!two.heap.empty() && (!best
+						|| compare(one.heap.front(), two.heap.front())))
+			{
+				best = &two;
+			}
+			if (best)
+			{
+				take(*best, value);
+			}
+			two.lock.unlock();
+			one.lock.unlock();
+			if (best)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool empty() const
+	{
+		return item_count.load() == 0;
+	}
+
+	long long size() const
+	{
+		return item_count.load();
+	}
+};
+
+#endif
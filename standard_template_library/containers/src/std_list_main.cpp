@@ -1,5 +1,6 @@
 #include <iostream>
-#include <list>
+
+#include "hive.h"
 
 void print_separator()
 {
@@ -16,8 +17,13 @@ int main()
 	/**
 	 * Instantiates an actual class where each instance of Type becomes an 
 	 * integer. Also declares int to be an oject to this instantiated class
+	 *
+	 * A Hive keeps its elements in blocks instead of one allocation per
+	 * element as std::list does, which makes printing a long list much
+	 * faster. Change the type back to std::list<int> (and insert back to
+	 * push_back) to compare.
 	 */
-	std::list<int> myList;
+	Hive<int> myList;
 	while (!done)
 	{
 		print_separator();
@@ -41,7 +47,7 @@ int main()
 				std::cout << "Enter the value to insert: ";
 				if (std::cin >> value)
 				{
-					myList.push_back(value);
+					myList.insert(value);
 				}
 				else
 				{
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <list>
+#include <vector>
+#include <cstdlib>
+
+#include "hive.h"
+#include "timing.h"
+
+/**
+ * Inserts size values, sums them, erases every third one through saved
+ * iterators, refills the gaps and sums again
+ */
+template <typename Container, typename Insert>
+void run(const char* name, std::size_t size, Insert insert)
+{
+	Container container;
+	std::vector<typename Container::iterator> positions;
+	positions.reserve(size);
+	long long first_sum = 0, second_sum = 0;
+
+	double insert_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				positions.push_back(insert(container, static_cast<int>(i)));
+			}
+		});
+	double iterate_time = time_msec([&] ()
+		{
+			for (int value : container)
+			{
+				first_sum += value;
+			}
+		});
+	double erase_time = time_msec([&] ()
+		{
+			for (std::size_t i = 0; i < size; i += 3)
+			{
+				container.erase(positions[i]);
+			}
+			for (std::size_t i = 0; i < size; i += 3)
+			{
+				insert(container, 1);
+			}
+		});
+	double again_time = time_msec([&] ()
+		{
+			for (int value : container)
+			{
+				second_sum += value;
+			}
+		});
+
+	std::cout << name << "    " << insert_time << "    " << iterate_time
+		<< "    " << erase_time << "    " << again_time << "    ("
+		<< first_sum << ", " << second_sum << ")\n";
+}
+
+
+int main(int argc, char* argv[])
+{
+	std::size_t size = argc > 1 ? std::atoll(argv[1]) : 10000000;
+
+	std::cout << "msec for " << size << " ints: insert, iterate, "
+		<< "erase a third and refill, iterate again\n";
+	run<std::list<int>>("std::list", size, [] (std::list<int>& list, int value)
+		{
+			return list.insert(std::end(list), value);
+		});
+	run<Hive<int>>("Hive     ", size, [] (Hive<int>& hive, int value)
+		{
+			return hive.insert(value);
+		});
+}
@@ -0,0 +1,18 @@
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include <chrono>
+
+/**
+ * Milliseconds of wall time taken by one call of work
+ */
+template <typename Function>
+double time_msec(Function work)
+{
+	auto start = std::chrono::steady_clock::now();
+	work();
+	return std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+}
+
+#endif